@@ -1,4 +1,4 @@
-use libcamera_meta::{control_ids, property_ids, Control};
+use libcamera_meta::{control_ids, property_ids, Control, ControlType};
 
 /// Converts `ExampleName` to `example_name`
 fn to_type_name(str: &str) -> String {
@@ -71,6 +71,56 @@ fn format_docstring(desc: &str, indent: usize) -> String {
         .collect()
 }
 
+/// Numeric value and name of `enum libcamera_control_type` corresponding to a yaml control type.
+///
+/// Values match `libcamera::ControlType` and cannot be referenced by name here, since
+/// `enum libcamera_control_type` is only defined in `controls.h` after this header is included.
+fn to_control_type(t: ControlType) -> (u8, &'static str) {
+    match t {
+        ControlType::Bool => (1, "bool"),
+        ControlType::Byte => (2, "byte"),
+        ControlType::Int32 => (3, "int32_t"),
+        ControlType::Int64 => (4, "int64_t"),
+        ControlType::Float => (5, "float"),
+        ControlType::String => (6, "string"),
+        ControlType::Rectangle => (7, "Rectangle"),
+        ControlType::Size => (8, "Size"),
+    }
+}
+
+fn generate_lookup_tables(controls: &Vec<Control>, name: &str) {
+    let upper = name.to_uppercase();
+
+    println!("#define LIBCAMERA_{}_ID_COUNT {}\n", upper, controls.len());
+
+    println!("#ifdef __cplusplus");
+    println!("/**");
+    println!(
+        " * \\brief Dense id-indexed lookup tables for {} metadata (index = id - 1)",
+        name
+    );
+    println!(" */");
+    println!(
+        "static constexpr const char *const libcamera_{}_id_names[LIBCAMERA_{}_ID_COUNT] = {{",
+        name, upper
+    );
+    for ctrl in controls.iter() {
+        println!("    \"{}\",", ctrl.name);
+    }
+    println!("}};\n");
+
+    println!(
+        "static constexpr uint8_t libcamera_{}_id_types[LIBCAMERA_{}_ID_COUNT] = {{",
+        name, upper
+    );
+    for ctrl in controls.iter() {
+        let (value, type_name) = to_control_type(ctrl.typ);
+        println!("    {}, /* {}: {} */", value, ctrl.name, type_name);
+    }
+    println!("}};");
+    println!("#endif\n");
+}
+
 fn generate_controls(controls: &Vec<Control>, name: &str) {
     let mut i = 1;
     println!("enum libcamera_{}_id {{", name);
@@ -100,13 +150,17 @@ fn main() {
     println!("/// Generated by `cargo run --bin generate_c`\n");
     println!("#ifndef __LIBCAMERA_C_CONTROLS_GENERATED__");
     println!("#define __LIBCAMERA_C_CONTROLS_GENERATED__");
+    println!();
+    println!("#include <stdint.h>");
     println!("\n");
 
     let controls = control_ids();
     generate_controls(&controls, "control");
+    generate_lookup_tables(&controls, "control");
 
     let properties = property_ids();
     generate_controls(&properties, "property");
+    generate_lookup_tables(&properties, "property");
 
     println!("#endif");
 }
@@ -53,6 +53,20 @@ fn to_rust_type(t: ControlType, size: &Option<Vec<ControlSize>>) -> String {
     }
 }
 
+/// `libcamera_control_type` constant name corresponding to a yaml control type.
+fn to_control_type_const(t: ControlType) -> &'static str {
+    match t {
+        ControlType::Bool => "LIBCAMERA_CONTROL_TYPE_BOOL",
+        ControlType::Byte => "LIBCAMERA_CONTROL_TYPE_BYTE",
+        ControlType::Int32 => "LIBCAMERA_CONTROL_TYPE_INT32",
+        ControlType::Int64 => "LIBCAMERA_CONTROL_TYPE_INT64",
+        ControlType::Float => "LIBCAMERA_CONTROL_TYPE_FLOAT",
+        ControlType::String => "LIBCAMERA_CONTROL_TYPE_STRING",
+        ControlType::Rectangle => "LIBCAMERA_CONTROL_TYPE_RECTANGLE",
+        ControlType::Size => "LIBCAMERA_CONTROL_TYPE_SIZE",
+    }
+}
+
 enum ControlsType {
     Control,
     Property,
@@ -75,6 +89,32 @@ fn generate_controls(controls: &Vec<Control>, ty: ControlsType) {
     }
     println!("}}\n");
 
+    println!("impl {} {{", name);
+    println!("    /// Returns the libcamera name, without crossing FFI.");
+    println!("    pub fn name(self) -> &'static str {{");
+    println!("        match self {{");
+    for ctrl in controls.iter() {
+        println!("            Self::{} => \"{}\",", &ctrl.name, &ctrl.name);
+    }
+    println!("        }}");
+    println!("    }}\n");
+    println!("    /// Returns the data type of the value as one of the");
+    println!(
+        "    /// [libcamera_control_type](libcamera_sys::libcamera_control_type) constants, without crossing FFI."
+    );
+    println!("    pub fn data_type(self) -> u32 {{");
+    println!("        match self {{");
+    for ctrl in controls.iter() {
+        println!(
+            "            Self::{} => libcamera_control_type::{},",
+            &ctrl.name,
+            to_control_type_const(ctrl.typ)
+        );
+    }
+    println!("        }}");
+    println!("    }}");
+    println!("}}\n");
+
     let mut dyn_variants = String::new();
 
     for ctrl in controls.iter() {
@@ -150,6 +190,41 @@ fn generate_controls(controls: &Vec<Control>, ty: ControlsType) {
             }}\n
         "};
 
+        // Non-string controls with a compile-time known element count get a direct
+        // memcpy path that skips ControlValue entirely.
+        let fixed_elements = match (ctrl.typ, &ctrl.size) {
+            (ControlType::String, _) => None,
+            (_, None) => Some(1usize),
+            (_, Some(s)) => s.iter().try_fold(1usize, |acc, s| match s {
+                ControlSize::Fixed(len) => Some(acc * *len as usize),
+                ControlSize::Dynamic => None,
+            }),
+        };
+
+        if ctrl.enumeration.is_none() {
+            if let Some(num_elements) = fixed_elements {
+                let type_const = to_control_type_const(ctrl.typ);
+                let is_array = ctrl.size.is_some();
+
+                printdoc! {"
+                    impl FixedSizeControlEntry for {ctrl_name} {{
+                        const TYPE: u32 = libcamera_control_type::{type_const};
+                        const NUM_ELEMENTS: usize = {num_elements};
+                        const IS_ARRAY: bool = {is_array};
+                        type Repr = {ctrl_type};
+
+                        fn from_repr(repr: Self::Repr) -> Self {{
+                            Self(repr)
+                        }}
+
+                        fn to_repr(&self) -> Self::Repr {{
+                            self.0
+                        }}
+                    }}\n
+                "};
+            }
+        }
+
         match ty {
             ControlsType::Control => println!("impl Control for {ctrl_name} {{}}\n"),
             ControlsType::Property => println!("impl Property for {ctrl_name} {{}}\n"),
@@ -176,7 +251,8 @@ fn main() {
             println!("//! Generated by `cargo run --bin generate_rust controls`\n");
             println!("use std::ops::{{Deref, DerefMut}};");
             println!("use num_enum::{{IntoPrimitive, TryFromPrimitive}};");
-            println!("use crate::control::{{Control, ControlEntry, DynControlEntry}};");
+            println!("use libcamera_sys::libcamera_control_type;");
+            println!("use crate::control::{{Control, ControlEntry, DynControlEntry, FixedSizeControlEntry}};");
             println!("use crate::control_value::{{ControlValue, ControlValueError}};");
             println!("#[allow(unused_imports)]");
             println!("use crate::geometry::{{Rectangle, Size}};\n");
@@ -187,7 +263,8 @@ fn main() {
             println!("//! Generated by `cargo run --bin generate_rust properties`\n");
             println!("use std::ops::{{Deref, DerefMut}};");
             println!("use num_enum::{{IntoPrimitive, TryFromPrimitive}};");
-            println!("use crate::control::{{Property, ControlEntry, DynControlEntry}};");
+            println!("use libcamera_sys::libcamera_control_type;");
+            println!("use crate::control::{{Property, ControlEntry, DynControlEntry, FixedSizeControlEntry}};");
             println!("use crate::control_value::{{ControlValue, ControlValueError}};");
             println!("#[allow(unused_imports)]");
             println!("use crate::geometry::{{Rectangle, Size}};\n");
@@ -0,0 +1,112 @@
+//! Benchmarks of FFI-crossing and hot-path control overhead.
+//!
+//! Everything here runs without camera hardware: lists are created from the global controls id
+//! map. Buffer mapping and request queueing can only be exercised against a real camera and are
+//! not covered.
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion};
+use libcamera_rs::{
+    control::{ControlList, ControlListBatch, ControlListSnapshot},
+    control_value::ControlValue,
+    controls::{self, ControlId},
+};
+
+/// Control list with a representative set of per-frame controls.
+fn populated_list() -> ControlList {
+    let mut list = ControlList::new();
+    let mut batch = ControlListBatch::new();
+    batch.set(controls::ExposureTime(10000));
+    batch.set(controls::AnalogueGain(2.0));
+    batch.set(controls::Brightness(0.5));
+    batch.set(controls::ColourGains([1.2, 1.4]));
+    batch.apply(&mut list).unwrap();
+    list
+}
+
+fn control_value(c: &mut Criterion) {
+    c.bench_function("control_value/from_i32", |b| {
+        b.iter(|| ControlValue::from(black_box(10000i32)))
+    });
+
+    c.bench_function("control_value/from_f32x2", |b| {
+        b.iter(|| ControlValue::from(black_box([1.2f32, 1.4])))
+    });
+
+    c.bench_function("control_value/to_f32x2", |b| {
+        let val = ControlValue::from([1.2f32, 1.4]);
+        b.iter(|| <[f32; 2]>::try_from(black_box(val.clone())).unwrap())
+    });
+}
+
+fn control_list(c: &mut Criterion) {
+    c.bench_function("control_list/get", |b| {
+        let list = populated_list();
+        b.iter(|| list.get::<controls::ExposureTime>().unwrap())
+    });
+
+    c.bench_function("control_list/get_fixed", |b| {
+        let list = populated_list();
+        b.iter(|| list.get_fixed::<controls::ExposureTime>().unwrap())
+    });
+
+    c.bench_function("control_list/set", |b| {
+        let mut list = populated_list();
+        b.iter(|| list.set(controls::ExposureTime(black_box(10000))).unwrap())
+    });
+
+    c.bench_function("control_list/set_fixed", |b| {
+        let mut list = populated_list();
+        b.iter(|| list.set_fixed(controls::ExposureTime(black_box(10000))).unwrap())
+    });
+
+    c.bench_function("control_list/batch_apply_4", |b| {
+        let mut list = populated_list();
+        let mut batch = ControlListBatch::new();
+        b.iter(|| {
+            batch.set(controls::ExposureTime(black_box(10000)));
+            batch.set(controls::AnalogueGain(2.0));
+            batch.set(controls::Brightness(0.5));
+            batch.set(controls::ColourGains([1.2, 1.4]));
+            batch.apply(&mut list).unwrap();
+        })
+    });
+
+    c.bench_function("control_list/iterate_ffi", |b| {
+        let list = populated_list();
+        b.iter(|| {
+            for (id, val) in &*list {
+                black_box((id, val));
+            }
+        })
+    });
+
+    c.bench_function("control_list/snapshot_capture", |b| {
+        let list = populated_list();
+        let mut snapshot = ControlListSnapshot::new();
+        b.iter(|| snapshot.capture(&list))
+    });
+
+    c.bench_function("control_list/snapshot_iterate", |b| {
+        let list = populated_list();
+        let mut snapshot = ControlListSnapshot::new();
+        snapshot.capture(&list);
+        b.iter(|| {
+            for (id, val) in snapshot.iter() {
+                black_box((id, val));
+            }
+        })
+    });
+}
+
+fn control_metadata(c: &mut Criterion) {
+    c.bench_function("control_id/name", |b| {
+        b.iter(|| black_box(ControlId::ExposureTime).name())
+    });
+
+    c.bench_function("control_id/data_type", |b| {
+        b.iter(|| black_box(ControlId::ExposureTime).data_type())
+    });
+}
+
+criterion_group!(benches, control_value, control_list, control_metadata);
+criterion_main!(benches);
@@ -1,17 +1,27 @@
 use std::{
-    collections::HashMap,
+    cell::UnsafeCell,
+    collections::hash_map::{Entry, HashMap},
     ffi::CStr,
     io,
     marker::PhantomData,
     ops::{Deref, DerefMut},
     ptr::NonNull,
-    sync::Mutex,
+    sync::{
+        atomic::{AtomicU8, Ordering},
+        Arc, Mutex,
+    },
 };
 
 use libcamera_sys::*;
 
+#[cfg(feature = "instrumentation")]
+use crate::instrumentation::{monotonic_ns, CaptureMetrics};
 use crate::{
-    control::{ControlInfoMapRef, ControlListRef, PropertyListRef},
+    completion::{CompletedRequests, CompletionRing},
+    control::{ControlInfoIndex, ControlInfoMapRef, ControlListRef, PropertyListRef},
+    framebuffer::{FrameBufferPlanesRef, FrameMetadataRef},
+    geometry::Size,
+    pixel_format::PixelFormat,
     request::Request,
     stream::{StreamConfigurationRef, StreamRole},
     utils::Immutable,
@@ -125,6 +135,73 @@ impl Drop for CameraConfiguration {
     }
 }
 
+/// Cache of validated [CameraConfiguration]s for fast mode switching.
+///
+/// [Camera::generate_configuration()] round-trips into the pipeline handler and heap-allocates a
+/// fresh configuration, and [CameraConfiguration::validate()] repeats pipeline negotiation — tens
+/// of milliseconds per mode switch. The cache keys validated configurations by (stream roles,
+/// size, pixel format), so a repeat switch to a previously used mode skips generation and
+/// validation entirely and goes straight to [ActiveCamera::configure()].
+///
+/// libcamera configurations are pipeline-specific objects with no way to clone them across the C
+/// API, so the cache stores and hands back the generated objects themselves. Cached entries are
+/// only valid for the camera they were generated from; keep one cache per camera.
+#[derive(Default)]
+pub struct ConfigCache {
+    entries: HashMap<(Vec<StreamRole>, Size, PixelFormat), CameraConfiguration>,
+}
+
+impl ConfigCache {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Returns a validated configuration for the given mode, generating it on first use.
+    ///
+    /// On a cache miss the configuration is generated for `roles`, its first stream is set to
+    /// `size` and `pixel_format` and the result is validated, during which libcamera may adjust
+    /// the requested values. Returns `None` if generation fails or the configuration is invalid.
+    pub fn get_or_generate(
+        &mut self,
+        camera: &Camera<'_>,
+        roles: &[StreamRole],
+        size: Size,
+        pixel_format: PixelFormat,
+    ) -> Option<&mut CameraConfiguration> {
+        match self.entries.entry((roles.to_vec(), size, pixel_format)) {
+            Entry::Occupied(entry) => Some(entry.into_mut()),
+            Entry::Vacant(entry) => {
+                let mut config = camera.generate_configuration(roles)?;
+
+                if let Some(mut stream_config) = config.get_mut(0) {
+                    stream_config.set_size(size);
+                    stream_config.set_pixel_format(pixel_format);
+                }
+
+                if config.validate().is_invalid() {
+                    return None;
+                }
+
+                Some(entry.insert(config))
+            }
+        }
+    }
+
+    /// Number of cached configurations.
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Drops all cached configurations, e.g. after the camera was released.
+    pub fn clear(&mut self) {
+        self.entries.clear();
+    }
+}
+
 /// A read-only instance of a camera.
 ///
 /// Can be used to obtain camera parameters or supported stream configurations.
@@ -199,22 +276,317 @@ impl<'d> Drop for Camera<'d> {
     }
 }
 
+/// Maximum number of live requests (created and not yet dropped) per camera.
+///
+/// Live requests are bounded by the number of allocated framebuffers, which is far below this
+/// limit in any realistic configuration.
+pub(crate) const MAX_IN_FLIGHT_REQUESTS: usize = 64;
+
+/// Slot states for [RequestSlots].
+const SLOT_EMPTY: u8 = 0;
+/// Slot belongs to a live [Request] that is not currently queued.
+const SLOT_ALLOCATED: u8 = 1;
+/// Transient state while the slot owner moves the [Request] in or out.
+const SLOT_BUSY: u8 = 2;
+const SLOT_QUEUED: u8 = 3;
+
+struct RequestSlot {
+    state: AtomicU8,
+    /// [Request] is stored while in flight. Accessed only by the slot owner ([SLOT_BUSY] state).
+    request: UnsafeCell<Option<Request>>,
+}
+
+/// Lock-free fixed-capacity storage for in-flight [Request]s, indexed by the libcamera cookie.
+///
+/// A slot is allocated for the lifetime of every [Request] at
+/// [ActiveCamera::create_request()] time and its index is stored as the libcamera cookie, which
+/// libcamera carries through the queue/complete round-trip. Completion dispatch is therefore a
+/// single array access instead of a lookup: `slots[cookie]`.
+///
+/// [Self::insert()] is executed on the caller thread of [ActiveCamera::queue_request()], while
+/// [Self::take()] runs in the libcamera camera manager thread. Slots move between states with
+/// atomic transitions (`EMPTY -> ALLOCATED <-> QUEUED`, through the transient `BUSY`) so neither
+/// path ever blocks the other.
+pub(crate) struct RequestSlots {
+    slots: [RequestSlot; MAX_IN_FLIGHT_REQUESTS],
+}
+
+impl Default for RequestSlots {
+    fn default() -> Self {
+        Self {
+            slots: core::array::from_fn(|_| RequestSlot {
+                state: AtomicU8::new(SLOT_EMPTY),
+                request: UnsafeCell::new(None),
+            }),
+        }
+    }
+}
+
+impl RequestSlots {
+    /// Claims a free slot for a new [Request]. Returns [None] if all slots are occupied.
+    fn allocate(self: &Arc<Self>) -> Option<RequestSlotHandle> {
+        for (index, slot) in self.slots.iter().enumerate() {
+            if slot
+                .state
+                .compare_exchange(SLOT_EMPTY, SLOT_ALLOCATED, Ordering::Acquire, Ordering::Relaxed)
+                .is_ok()
+            {
+                return Some(RequestSlotHandle {
+                    slots: self.clone(),
+                    index,
+                });
+            }
+        }
+        None
+    }
+
+    /// Stores an in-flight request into its own slot. Returns it back if the slot is not free,
+    /// which cannot happen since queueing consumes the [Request].
+    fn insert(&self, req: Request) -> Result<(), Request> {
+        let slot = &self.slots[req.slot.index];
+        if slot
+            .state
+            .compare_exchange(SLOT_ALLOCATED, SLOT_BUSY, Ordering::Acquire, Ordering::Relaxed)
+            .is_err()
+        {
+            return Err(req);
+        }
+
+        // Slot is exclusively owned after a successful CAS to BUSY.
+        unsafe { *slot.request.get() = Some(req) };
+        slot.state.store(SLOT_QUEUED, Ordering::Release);
+        Ok(())
+    }
+
+    /// Takes the request stored in a given slot, leaving the slot allocated to it.
+    fn take(&self, index: usize) -> Option<Request> {
+        let slot = self.slots.get(index)?;
+        if slot
+            .state
+            .compare_exchange(SLOT_QUEUED, SLOT_BUSY, Ordering::Acquire, Ordering::Relaxed)
+            .is_err()
+        {
+            return None;
+        }
+
+        let req = unsafe { (*slot.request.get()).take() };
+        slot.state.store(SLOT_ALLOCATED, Ordering::Release);
+        req
+    }
+
+    /// Reads the user cookie of the request stored in a given slot.
+    ///
+    /// Must only be called from the libcamera thread: it is the only thread that takes queued
+    /// requests out of their slots, so the stored request cannot move while this reads it.
+    fn user_cookie(&self, index: usize) -> Option<u64> {
+        let slot = self.slots.get(index)?;
+        if slot.state.load(Ordering::Acquire) != SLOT_QUEUED {
+            return None;
+        }
+        unsafe { (*slot.request.get()).as_ref().map(|r| r.cookie()) }
+    }
+
+    /// Takes all in-flight requests out of their slots, dropping them.
+    ///
+    /// Called when the camera is released: cancelled requests whose completion was never
+    /// observed would otherwise keep their slots (and through [RequestSlotHandle] this storage)
+    /// alive forever.
+    fn drain(&self) {
+        for index in 0..self.slots.len() {
+            drop(self.take(index));
+        }
+    }
+}
+
+/// Slot access is synchronized by the atomic state machine, see [RequestSlots].
+unsafe impl Sync for RequestSlots {}
+
+/// Owns one [RequestSlots] slot for the lifetime of a [Request].
+///
+/// The slot index doubles as the libcamera cookie of the request, see [RequestSlots].
+pub(crate) struct RequestSlotHandle {
+    slots: Arc<RequestSlots>,
+    index: usize,
+}
+
+impl RequestSlotHandle {
+    /// Slot index, stored as the libcamera cookie of the owning request.
+    pub(crate) fn index(&self) -> usize {
+        self.index
+    }
+}
+
+impl Drop for RequestSlotHandle {
+    fn drop(&mut self) {
+        // The handle is dropped together with its Request, which at that point is not stored in
+        // the slot, so the slot is ALLOCATED and simply becomes free again.
+        self.slots.slots[self.index].state.store(SLOT_EMPTY, Ordering::Release);
+    }
+}
+
+/// Queueing state of [ActiveCameraState] that is also reachable through [Requeuer].
+#[derive(Default)]
+struct QueueState {
+    requests: Arc<RequestSlots>,
+    #[cfg(feature = "instrumentation")]
+    metrics: CaptureMetrics,
+}
+
+/// Stores the request in a slot and queues it for execution, see [ActiveCamera::queue_request()].
+fn queue_request_raw(cam: *mut libcamera_camera_t, queue: &QueueState, req: Request) -> io::Result<()> {
+    #[cfg(feature = "instrumentation")]
+    let req = {
+        let mut req = req;
+        req.queued_at = monotonic_ns();
+        req
+    };
+
+    // Completion dispatch indexes this camera's slots by the libcamera cookie, so a request
+    // created by another camera must not end up in them.
+    if !Arc::ptr_eq(&req.slot.slots, &queue.requests) {
+        return Err(io::ErrorKind::InvalidInput.into());
+    }
+
+    let index = req.slot.index();
+    let ptr = req.ptr.as_ptr();
+    if queue.requests.insert(req).is_err() {
+        return Err(io::ErrorKind::WouldBlock.into());
+    }
+
+    #[cfg(feature = "instrumentation")]
+    let call_start = monotonic_ns();
+
+    let ret = unsafe { libcamera_camera_queue_request(cam, ptr) };
+
+    #[cfg(feature = "instrumentation")]
+    queue.metrics.record_queued(monotonic_ns().saturating_sub(call_start));
+
+    if ret < 0 {
+        // Reclaim the request so that its buffers are released back to the caller.
+        queue.requests.take(index);
+        Err(io::Error::from_raw_os_error(ret))
+    } else {
+        Ok(())
+    }
+}
+
+/// Detached handle that can requeue requests without borrowing [ActiveCamera].
+///
+/// Used by [CaptureLoop](crate::capture_loop::CaptureLoop) to requeue dropped frames from within
+/// the request completed callback, which runs in the libcamera thread where no reference to the
+/// [ActiveCamera] is available.
+pub(crate) struct Requeuer {
+    /// Own `shared_ptr` copy keeping the camera alive.
+    cam: NonNull<libcamera_camera_t>,
+    /// Points into [ActiveCameraState], which outlives the callback holding this handle.
+    queue: *const QueueState,
+}
+
+// Safe to send to the libcamera thread: queue_request_raw() is the same lock-free path that
+// ActiveCamera::queue_request() uses from arbitrary caller threads.
+unsafe impl Send for Requeuer {}
+/// Concurrent queueing is safe: the slot storage is CAS-based and `Camera::queueRequest()` is
+/// thread-safe in libcamera.
+unsafe impl Sync for Requeuer {}
+
+impl Requeuer {
+    pub(crate) fn queue(&self, req: Request) -> io::Result<()> {
+        queue_request_raw(self.cam.as_ptr(), unsafe { &*self.queue }, req)
+    }
+}
+
+impl Drop for Requeuer {
+    fn drop(&mut self) {
+        unsafe { libcamera_camera_destroy(self.cam.as_ptr()) }
+    }
+}
+
+/// A framebuffer that finished capturing while its [Request] is still executing.
+///
+/// Passed to the callback set by [ActiveCamera::on_buffer_completed()]. In multi-stream
+/// configurations this allows processing of a stream's buffer to start as soon as it is filled,
+/// instead of waiting for the entire request to complete.
+pub struct BufferCompleted<'a> {
+    req: NonNull<libcamera_request_t>,
+    buffer: NonNull<libcamera_framebuffer_t>,
+    /// User cookie of the request, read out of its slot, see [RequestSlots::user_cookie()].
+    cookie: u64,
+    _phantom: PhantomData<&'a ()>,
+}
+
+impl<'a> BufferCompleted<'a> {
+    /// Cookie of the request that the buffer belongs to, as provided in
+    /// [ActiveCamera::create_request()].
+    pub fn cookie(&self) -> u64 {
+        self.cookie
+    }
+
+    /// Sequence number of the request that the buffer belongs to.
+    pub fn sequence(&self) -> u32 {
+        unsafe { libcamera_request_sequence(self.req.as_ptr()) }
+    }
+
+    /// Metadata of the completed framebuffer.
+    pub fn metadata(&self) -> Immutable<FrameMetadataRef<'_>> {
+        Immutable(unsafe {
+            FrameMetadataRef::from_ptr(
+                NonNull::new(libcamera_framebuffer_metadata(self.buffer.as_ptr()).cast_mut()).unwrap(),
+            )
+        })
+    }
+
+    /// Plane file descriptors, offsets and lengths of the completed framebuffer.
+    pub fn planes(&self) -> Immutable<FrameBufferPlanesRef<'_>> {
+        Immutable(unsafe {
+            FrameBufferPlanesRef::from_ptr(
+                NonNull::new(libcamera_framebuffer_planes(self.buffer.as_ptr()).cast_mut()).unwrap(),
+            )
+        })
+    }
+}
+
+extern "C" fn camera_buffer_completed_cb(
+    ptr: *mut core::ffi::c_void,
+    req: *mut libcamera_request_t,
+    buffer: *mut libcamera_framebuffer_t,
+) {
+    let state = unsafe { &*(ptr as *const ActiveCameraState) };
+
+    if let Some(cb) = state.buffer_completed_cb.lock().unwrap().as_mut() {
+        let index = unsafe { libcamera_request_cookie(req) } as usize;
+        cb(BufferCompleted {
+            req: NonNull::new(req).unwrap(),
+            buffer: NonNull::new(buffer).unwrap(),
+            cookie: state.queue.requests.user_cookie(index).unwrap_or(0),
+            _phantom: Default::default(),
+        });
+    }
+}
+
 extern "C" fn camera_request_completed_cb(ptr: *mut core::ffi::c_void, req: *mut libcamera_request_t) {
-    let mut state = unsafe { &*(ptr as *const Mutex<ActiveCameraState>) }.lock().unwrap();
-    let req = state.requests.remove(&req).unwrap();
+    let state = unsafe { &*(ptr as *const ActiveCameraState) };
+    // The libcamera cookie is the request's slot index, so dispatch is a single array access.
+    let index = unsafe { libcamera_request_cookie(req) } as usize;
+    let req = state.queue.requests.take(index).unwrap();
+
+    #[cfg(feature = "instrumentation")]
+    state.queue.metrics.record_completed(&req);
 
-    if let Some(cb) = &mut state.request_completed_cb {
+    if let Some(cb) = state.request_completed_cb.lock().unwrap().as_mut() {
         cb(req);
     }
 }
 
 #[derive(Default)]
 struct ActiveCameraState<'d> {
-    /// List of queued requests that are yet to be executed.
-    /// Used to temporarily store [Request] before returning it back to the user.
-    requests: HashMap<*mut libcamera_request_t, Request>,
+    /// In-flight request storage (and capture metrics with the `instrumentation` feature).
+    queue: QueueState,
     /// Callback for libcamera `requestCompleted` signal.
-    request_completed_cb: Option<Box<dyn FnMut(Request) + Send + 'd>>,
+    ///
+    /// Mutex is only contended when the callback is replaced, queueing never touches it.
+    request_completed_cb: Mutex<Option<Box<dyn FnMut(Request) + Send + 'd>>>,
+    /// Callback for libcamera `bufferCompleted` signal.
+    buffer_completed_cb: Mutex<Option<Box<dyn FnMut(BufferCompleted) + Send + 'd>>>,
 }
 
 /// An active instance of a camera.
@@ -226,26 +598,43 @@ pub struct ActiveCamera<'d> {
     cam: Camera<'d>,
     /// Handle to disconnect `requestCompleted` signal.
     request_completed_handle: *mut libcamera_callback_handle_t,
+    /// Handle to disconnect `bufferCompleted` signal.
+    buffer_completed_handle: *mut libcamera_callback_handle_t,
+    /// Flat index of control limits, built once at acquisition, see [Self::control_index()].
+    control_index: ControlInfoIndex,
     /// Internal state that is shared with callback handlers.
-    state: Box<Mutex<ActiveCameraState<'d>>>,
+    state: Box<ActiveCameraState<'d>>,
 }
 
 impl<'d> ActiveCamera<'d> {
     pub(crate) unsafe fn from_ptr(ptr: NonNull<libcamera_camera_t>) -> Self {
-        let mut state = Box::new(Mutex::new(ActiveCameraState::default()));
+        let mut state = Box::new(ActiveCameraState::default());
 
         let request_completed_handle = unsafe {
             libcamera_camera_request_completed_connect(
                 ptr.as_ptr(),
                 Some(camera_request_completed_cb),
                 // state is valid for the lifetime of `ActiveCamera` and this callback will be disconnected on drop.
-                state.as_mut() as *mut Mutex<ActiveCameraState> as *mut _,
+                state.as_mut() as *mut ActiveCameraState as *mut _,
             )
         };
 
+        let buffer_completed_handle = unsafe {
+            libcamera_camera_buffer_completed_connect(
+                ptr.as_ptr(),
+                Some(camera_buffer_completed_cb),
+                state.as_mut() as *mut ActiveCameraState as *mut _,
+            )
+        };
+
+        let cam = Camera::from_ptr(ptr);
+        let control_index = ControlInfoIndex::from_map(&cam.controls());
+
         Self {
-            cam: Camera::from_ptr(ptr),
+            cam,
             request_completed_handle,
+            buffer_completed_handle,
+            control_index,
             state,
         }
     }
@@ -256,8 +645,32 @@ impl<'d> ActiveCamera<'d> {
     ///
     /// Only one callback can be set at a time. If there was a previously set callback, it will be discarded when setting a new one.
     pub fn on_request_completed(&mut self, cb: impl FnMut(Request) + Send + 'd) {
-        let mut state = self.state.lock().unwrap();
-        state.request_completed_cb = Some(Box::new(cb));
+        *self.state.request_completed_cb.lock().unwrap() = Some(Box::new(cb));
+    }
+
+    /// Sets a callback for completed framebuffers.
+    ///
+    /// Unlike [Self::on_request_completed()], this fires for each stream's buffer as soon as it has
+    /// been filled, while other buffers of the same request may still be capturing. This enables
+    /// per-stream pipelining in multi-stream configurations.
+    ///
+    /// Callback is executed in the libcamera thread context, see [Self::on_request_completed()] for details.
+    pub fn on_buffer_completed(&mut self, cb: impl FnMut(BufferCompleted) + Send + 'd) {
+        *self.state.buffer_completed_cb.lock().unwrap() = Some(Box::new(cb));
+    }
+
+    /// Returns an asynchronous stream of completed requests.
+    ///
+    /// Replaces any callback previously set by [Self::on_request_completed()]: completions are
+    /// pushed into a lock-free ring and the consumer task is woken directly, making frames
+    /// available to async code without intermediate channels. See [CompletedRequests].
+    pub fn completed_requests(&mut self) -> CompletedRequests {
+        let ring = Arc::new(CompletionRing::default());
+
+        let producer = ring.clone();
+        self.on_request_completed(move |req| producer.push(req));
+
+        CompletedRequests::new(ring)
     }
 
     /// Applies camera configuration.
@@ -280,27 +693,49 @@ impl<'d> ActiveCamera<'d> {
     /// # Arguments
     ///
     /// * `cookie` - An optional user-provided u64 identifier that can be used to uniquely identify request in request completed callback.
+    ///
+    /// Returns [None] if the number of live requests reached internal capacity, far above the
+    /// number of framebuffers that could back them.
     pub fn create_request(&mut self, cookie: Option<u64>) -> Option<Request> {
-        let req = unsafe { libcamera_camera_create_request(self.ptr.as_ptr(), cookie.unwrap_or(0)) };
-        NonNull::new(req).map(|p| unsafe { Request::from_ptr(p) })
+        // The libcamera cookie is the index of the slot that holds the request while in flight,
+        // so that completions dispatch with a single array access. The user cookie is kept in the
+        // Request itself, see Request::cookie().
+        let slot = self.state.queue.requests.allocate()?;
+        let req = unsafe { libcamera_camera_create_request(self.ptr.as_ptr(), slot.index() as u64) };
+        NonNull::new(req).map(|p| unsafe { Request::from_ptr(p, cookie.unwrap_or(0), slot) })
     }
 
     /// Queues [`Request`] for execution. Completed requests are returned in request completed callback, set by the `ActiveCamera::on_request_completed()`.
     ///
     /// Requests that do not have attached framebuffers are invalid and are rejected without being queued.
+    ///
+    /// Fails with [io::ErrorKind::InvalidInput] if the request was created by a different camera.
     pub fn queue_request(&self, req: Request) -> io::Result<()> {
-        let ptr = req.ptr.as_ptr();
-        self.state.lock().unwrap().requests.insert(ptr, req);
-
-        let ret = unsafe { libcamera_camera_queue_request(self.ptr.as_ptr(), ptr) };
+        queue_request_raw(self.ptr.as_ptr(), &self.state.queue, req)
+    }
 
-        if ret < 0 {
-            Err(io::Error::from_raw_os_error(ret))
-        } else {
-            Ok(())
+    /// Returns a detached requeueing handle for use in completion callbacks, see [Requeuer].
+    pub(crate) fn requeuer(&self) -> Requeuer {
+        Requeuer {
+            cam: NonNull::new(unsafe { libcamera_camera_copy(self.ptr.as_ptr()) }).unwrap(),
+            queue: &self.state.queue as *const QueueState,
         }
     }
 
+    /// Control limits of this camera as a flat sorted index, see [ControlInfoIndex].
+    ///
+    /// Unlike [Camera::controls()], lookups do not cross FFI, so control values can be validated
+    /// or clamped on the hot path before every queued request.
+    pub fn control_index(&self) -> &ControlInfoIndex {
+        &self.control_index
+    }
+
+    /// Capture latency metrics of this camera, see [CaptureMetrics].
+    #[cfg(feature = "instrumentation")]
+    pub fn metrics(&self) -> &CaptureMetrics {
+        &self.state.queue.metrics
+    }
+
     /// Starts camera capture session.
     ///
     /// Once started, [ActiveCamera::queue_request()] is permitted and camera configuration can no longer be changed.
@@ -344,9 +779,14 @@ impl<'d> DerefMut for ActiveCamera<'d> {
 impl<'d> Drop for ActiveCamera<'d> {
     fn drop(&mut self) {
         unsafe {
+            libcamera_camera_buffer_completed_disconnect(self.ptr.as_ptr(), self.buffer_completed_handle);
             libcamera_camera_request_completed_disconnect(self.ptr.as_ptr(), self.request_completed_handle);
             libcamera_camera_stop(self.ptr.as_ptr());
             libcamera_camera_release(self.ptr.as_ptr());
         }
+
+        // Requests cancelled by the stop above completed with the callback already disconnected,
+        // drop them out of their slots.
+        self.state.queue.requests.drain();
     }
 }
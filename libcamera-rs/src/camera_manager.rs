@@ -1,27 +1,149 @@
-use std::{ffi::CStr, marker::PhantomData, ptr::NonNull};
+use std::{ffi::CStr, io, marker::PhantomData, ptr::NonNull, sync::Mutex};
 
 use libcamera_sys::*;
 
 use crate::camera::Camera;
 
+/// Hotplug callback, receives the added or removed camera.
+type HotplugCallback = Box<dyn for<'a> FnMut(Camera<'a>) + Send + 'static>;
+
+#[derive(Default)]
+struct CameraManagerState {
+    /// Callback for libcamera `cameraAdded` signal.
+    camera_added_cb: Mutex<Option<HotplugCallback>>,
+    /// Callback for libcamera `cameraRemoved` signal.
+    camera_removed_cb: Mutex<Option<HotplugCallback>>,
+}
+
+extern "C" fn camera_manager_camera_added_cb(ptr: *mut core::ffi::c_void, cam: *mut libcamera_camera_t) {
+    let state = unsafe { &*(ptr as *const CameraManagerState) };
+    let cam = unsafe { Camera::from_ptr(NonNull::new(cam).unwrap()) };
+
+    if let Some(cb) = state.camera_added_cb.lock().unwrap().as_mut() {
+        cb(cam);
+    }
+}
+
+extern "C" fn camera_manager_camera_removed_cb(ptr: *mut core::ffi::c_void, cam: *mut libcamera_camera_t) {
+    let state = unsafe { &*(ptr as *const CameraManagerState) };
+    let cam = unsafe { Camera::from_ptr(NonNull::new(cam).unwrap()) };
+
+    if let Some(cb) = state.camera_removed_cb.lock().unwrap().as_mut() {
+        cb(cam);
+    }
+}
+
+/// Copies borrowed camera id strings into `out`, reusing its allocations.
+fn copy_ids(out: &mut Vec<String>, ids: &[*const std::os::raw::c_char]) {
+    out.truncate(ids.len());
+    for (i, ptr) in ids.iter().enumerate() {
+        let id = unsafe { CStr::from_ptr(*ptr) }.to_str().unwrap();
+        match out.get_mut(i) {
+            Some(s) => {
+                s.clear();
+                s.push_str(id);
+            }
+            None => out.push(id.to_string()),
+        }
+    }
+}
+
 /// Camera manager used to enumerate available cameras in the system.
 pub struct CameraManager {
     ptr: NonNull<libcamera_camera_manager_t>,
+    /// Handle to disconnect `cameraAdded` signal.
+    camera_added_handle: *mut libcamera_callback_handle_t,
+    /// Handle to disconnect `cameraRemoved` signal.
+    camera_removed_handle: *mut libcamera_callback_handle_t,
+    /// Internal state that is shared with callback handlers.
+    state: Box<CameraManagerState>,
 }
 
 impl CameraManager {
     /// Initializes `libcamera` and creates [Self].
-    pub fn new() -> std::io::Result<Self> {
-        let ptr = NonNull::new(unsafe { libcamera_camera_manager_create() }).unwrap();
-        let ret = unsafe { libcamera_camera_manager_start(ptr.as_ptr()) };
+    ///
+    /// Blocks while libcamera enumerates and probes all media devices, which can take hundreds of
+    /// milliseconds. Use [Self::new_in_background()] to overlap this with application startup.
+    pub fn new() -> io::Result<Self> {
+        let mgr = Self::create();
+        let ret = unsafe { libcamera_camera_manager_start(mgr.ptr.as_ptr()) };
 
         if ret < 0 {
-            Err(std::io::Error::from_raw_os_error(ret))
+            Err(io::Error::from_raw_os_error(ret))
         } else {
-            Ok(CameraManager { ptr })
+            Ok(mgr)
+        }
+    }
+
+    /// Initializes `libcamera` in a background thread.
+    ///
+    /// Device enumeration and probing run concurrently with the caller. Cameras can be delivered
+    /// as they are found by setting [PendingCameraManager::on_camera_added()] before probing
+    /// reaches them; [PendingCameraManager::wait()] joins the startup and returns the manager.
+    pub fn new_in_background() -> PendingCameraManager {
+        let mgr = Self::create();
+
+        let ptr = SendCameraManagerPtr(mgr.ptr);
+        let thread = std::thread::spawn(move || {
+            let ptr = ptr;
+            unsafe { libcamera_camera_manager_start(ptr.0.as_ptr()) }
+        });
+
+        PendingCameraManager {
+            mgr: Some(mgr),
+            thread: Some(thread),
+        }
+    }
+
+    /// Creates an unstarted manager with hotplug signals connected.
+    fn create() -> Self {
+        let ptr = NonNull::new(unsafe { libcamera_camera_manager_create() }).unwrap();
+        let state = Box::new(CameraManagerState::default());
+
+        let camera_added_handle = unsafe {
+            libcamera_camera_manager_camera_added_connect(
+                ptr.as_ptr(),
+                Some(camera_manager_camera_added_cb),
+                // state is valid for the lifetime of `CameraManager` and this callback will be disconnected on drop.
+                state.as_ref() as *const CameraManagerState as *mut _,
+            )
+        };
+
+        let camera_removed_handle = unsafe {
+            libcamera_camera_manager_camera_removed_connect(
+                ptr.as_ptr(),
+                Some(camera_manager_camera_removed_cb),
+                state.as_ref() as *const CameraManagerState as *mut _,
+            )
+        };
+
+        Self {
+            ptr,
+            camera_added_handle,
+            camera_removed_handle,
+            state,
         }
     }
 
+    /// Sets a callback for cameras appearing in the system.
+    ///
+    /// Fired for hotplugged cameras and, if set before enumeration (see
+    /// [Self::new_in_background()]), for cameras present at startup. The callback is executed in
+    /// the libcamera thread context, see
+    /// [ActiveCamera::on_request_completed()](crate::camera::ActiveCamera::on_request_completed) for details.
+    ///
+    /// Only one callback can be set at a time. If there was a previously set callback, it will be discarded when setting a new one.
+    pub fn on_camera_added(&self, cb: impl for<'a> FnMut(Camera<'a>) + Send + 'static) {
+        *self.state.camera_added_cb.lock().unwrap() = Some(Box::new(cb));
+    }
+
+    /// Sets a callback for cameras disappearing from the system.
+    ///
+    /// See [Self::on_camera_added()] for details.
+    pub fn on_camera_removed(&self, cb: impl for<'a> FnMut(Camera<'a>) + Send + 'static) {
+        *self.state.camera_removed_cb.lock().unwrap() = Some(Box::new(cb));
+    }
+
     /// Returns version string of the linked libcamera.
     pub fn version(&self) -> &str {
         unsafe { CStr::from_ptr(libcamera_camera_manager_version(self.ptr.as_ptr())) }
@@ -33,17 +155,111 @@ impl CameraManager {
     pub fn cameras(&self) -> CameraList {
         unsafe { CameraList::from_ptr(NonNull::new(libcamera_camera_manager_cameras(self.ptr.as_ptr())).unwrap()) }
     }
+
+    /// Returns ids of all cameras currently in the system.
+    ///
+    /// See [Self::camera_ids_into()], which this wraps.
+    pub fn camera_ids(&self) -> Vec<String> {
+        let mut ids = Vec::new();
+        self.camera_ids_into(&mut ids);
+        ids
+    }
+
+    /// Writes ids of all cameras currently in the system into `out`, reusing its allocations.
+    ///
+    /// Unlike [Self::cameras()], which copies a vector of `shared_ptr`s and clones another one per
+    /// accessed camera, this reads the id strings straight out of the camera objects in a single
+    /// FFI call and reuses the capacity of `out` and its strings, so periodic presence polling
+    /// causes no refcount traffic and no steady-state allocations. Use [Self::get_by_id()] to
+    /// obtain a [Camera] once one is actually selected.
+    pub fn camera_ids_into(&self, out: &mut Vec<String>) {
+        // Borrowed id pointers are only valid while the cameras cannot disappear, so they are
+        // copied out before returning. Fixed stack buffer keeps the common path allocation-free.
+        let mut ids = [core::ptr::null(); 32];
+
+        let total = unsafe { libcamera_camera_manager_enumerate(self.ptr.as_ptr(), ids.as_mut_ptr(), ids.len() as _) };
+
+        if total <= ids.len() {
+            copy_ids(out, &ids[..total]);
+        } else {
+            // More cameras than fit the stack buffer, retry through the heap.
+            let mut ids = vec![core::ptr::null(); total];
+            let total =
+                unsafe { libcamera_camera_manager_enumerate(self.ptr.as_ptr(), ids.as_mut_ptr(), ids.len() as _) }
+                    .min(ids.len());
+            copy_ids(out, &ids[..total]);
+        }
+    }
+
+    /// Returns the camera with the given id, taking a reference to it.
+    ///
+    /// Ids are obtained from [Self::camera_ids()] or [Camera::id()].
+    pub fn get_by_id(&self, id: &str) -> Option<Camera<'_>> {
+        let id = std::ffi::CString::new(id).ok()?;
+        let ptr = unsafe { libcamera_camera_manager_get_id(self.ptr.as_ptr(), id.as_ptr()) };
+        NonNull::new(ptr).map(|p| unsafe { Camera::from_ptr(p) })
+    }
 }
 
 impl Drop for CameraManager {
     fn drop(&mut self) {
         unsafe {
+            libcamera_camera_manager_camera_removed_disconnect(self.ptr.as_ptr(), self.camera_removed_handle);
+            libcamera_camera_manager_camera_added_disconnect(self.ptr.as_ptr(), self.camera_added_handle);
             libcamera_camera_manager_stop(self.ptr.as_ptr());
             libcamera_camera_manager_destroy(self.ptr.as_ptr());
         }
     }
 }
 
+/// Raw manager pointer handed to the startup thread, see [CameraManager::new_in_background()].
+struct SendCameraManagerPtr(NonNull<libcamera_camera_manager_t>);
+unsafe impl Send for SendCameraManagerPtr {}
+
+/// A [CameraManager] that is still starting up in a background thread.
+///
+/// Created by [CameraManager::new_in_background()]. Hotplug callbacks can be registered while
+/// enumeration is in progress; all other camera manager functionality becomes available after
+/// [Self::wait()].
+pub struct PendingCameraManager {
+    mgr: Option<CameraManager>,
+    thread: Option<std::thread::JoinHandle<i32>>,
+}
+
+impl PendingCameraManager {
+    /// Sets a callback for discovered cameras, see [CameraManager::on_camera_added()].
+    ///
+    /// When set before enumeration reaches a camera, the callback fires for it during startup.
+    pub fn on_camera_added(&self, cb: impl for<'a> FnMut(Camera<'a>) + Send + 'static) {
+        self.mgr.as_ref().unwrap().on_camera_added(cb);
+    }
+
+    /// Sets a callback for removed cameras, see [CameraManager::on_camera_removed()].
+    pub fn on_camera_removed(&self, cb: impl for<'a> FnMut(Camera<'a>) + Send + 'static) {
+        self.mgr.as_ref().unwrap().on_camera_removed(cb);
+    }
+
+    /// Waits for the startup to finish and returns the started [CameraManager].
+    pub fn wait(mut self) -> io::Result<CameraManager> {
+        let ret = self.thread.take().unwrap().join().unwrap();
+
+        if ret < 0 {
+            Err(io::Error::from_raw_os_error(ret))
+        } else {
+            Ok(self.mgr.take().unwrap())
+        }
+    }
+}
+
+impl Drop for PendingCameraManager {
+    fn drop(&mut self) {
+        // The startup thread borrows the manager pointer, join it before the manager is dropped.
+        if let Some(thread) = self.thread.take() {
+            let _ = thread.join();
+        }
+    }
+}
+
 pub struct CameraList<'d> {
     ptr: NonNull<libcamera_camera_list_t>,
     _phantom: PhantomData<&'d ()>,
@@ -0,0 +1,512 @@
+use std::{
+    io,
+    ops::Deref,
+    sync::{
+        atomic::{AtomicU64, AtomicUsize, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    time::Duration,
+};
+
+use crate::{
+    camera::ActiveCamera,
+    control::ControlListRef,
+    controls,
+    framebuffer_allocator::{FrameBuffer, FrameBufferAllocator},
+    framebuffer_map::MemoryMappedFrameBuffer,
+    request::{Request, RequestStatus, ReuseFlag},
+    stream::Stream,
+    utils::monotonic_ns,
+};
+
+/// Completions between shrink decisions of [AdaptiveQueueDepth], about a second of video.
+const DEPTH_ADJUST_WINDOW: u32 = 30;
+
+/// Clean completions required after a sequence gap before shrinking is considered again.
+const DEPTH_GAP_COOLDOWN: u32 = 4 * DEPTH_ADJUST_WINDOW;
+
+/// Controller that adapts the number of in-flight requests at runtime.
+///
+/// How many requests to keep queued is the central latency/throughput trade-off of a capture
+/// pipeline: too few and the ISP starves (visible as gaps in the frame sequence numbers), too
+/// many and glass-to-callback latency grows by a frame duration per extra buffer. Instead of
+/// hand-tuning the depth per sensor, the controller watches both signals on every completion:
+///
+/// * a sequence gap means the sensor captured a frame with no request queued - the depth grows
+///   by one immediately, and shrinking is suspended for a cooldown period,
+/// * when the smoothed sensor-to-completion latency sits above the target and no gaps occurred
+///   for a full adjustment window, the depth shrinks by one.
+///
+/// The depth therefore settles on the smallest value that produces zero drops, bounded by the
+/// allocated buffer count. Used with [CaptureLoop::new_adaptive()]; requests beyond the current
+/// depth wait in a standby pool instead of being queued.
+pub struct AdaptiveQueueDepth {
+    min_depth: usize,
+    max_depth: usize,
+    target_latency_ns: u64,
+    /// Current in-flight target.
+    depth: usize,
+    /// Smoothed sensor-to-completion latency (1/8 EWMA), 0 until the first sample.
+    latency_ewma_ns: u64,
+    last_sequence: Option<u32>,
+    gaps: u64,
+    /// Completions since the last adjustment.
+    window: u32,
+    /// Completions left before shrinking is allowed again after a gap.
+    cooldown: u32,
+}
+
+impl AdaptiveQueueDepth {
+    /// Creates a controller holding the in-flight depth within `min_depth..=max_depth`.
+    ///
+    /// `target_latency` is the sensor-to-completion latency to hold; the controller starts at
+    /// `max_depth` for drop-free startup and shrinks toward the target from there. `max_depth`
+    /// is additionally capped to the allocated buffer count by [CaptureLoop::new_adaptive()].
+    pub fn new(min_depth: usize, max_depth: usize, target_latency: Duration) -> Self {
+        let min_depth = min_depth.max(1);
+        let max_depth = max_depth.max(min_depth);
+        Self {
+            min_depth,
+            max_depth,
+            target_latency_ns: target_latency.as_nanos() as u64,
+            depth: max_depth,
+            latency_ewma_ns: 0,
+            last_sequence: None,
+            gaps: 0,
+            window: 0,
+            cooldown: 0,
+        }
+    }
+
+    /// Current in-flight request target.
+    pub fn depth(&self) -> usize {
+        self.depth
+    }
+
+    /// Total number of missed frames observed as sequence gaps.
+    pub fn sequence_gaps(&self) -> u64 {
+        self.gaps
+    }
+
+    /// Smoothed sensor-to-completion latency in ns, 0 before the first completion.
+    pub fn latency_ns(&self) -> u64 {
+        self.latency_ewma_ns
+    }
+
+    /// Caps the depth bounds to the allocated buffer count.
+    fn cap_to_buffers(&mut self, buffers: usize) {
+        self.max_depth = self.max_depth.min(buffers).max(1);
+        self.min_depth = self.min_depth.min(self.max_depth);
+        self.depth = self.depth.clamp(self.min_depth, self.max_depth);
+    }
+
+    /// Forgets sequence tracking across a capture restart.
+    fn restart(&mut self) {
+        self.last_sequence = None;
+        self.window = 0;
+    }
+
+    /// Feeds one completion into the controller and returns the updated depth target.
+    fn observe(&mut self, sequence: u32, latency_ns: Option<u64>) -> usize {
+        if let Some(last) = self.last_sequence {
+            let missed = sequence.wrapping_sub(last.wrapping_add(1));
+            if missed != 0 {
+                self.gaps += missed as u64;
+                self.depth = (self.depth + 1).min(self.max_depth);
+                self.cooldown = DEPTH_GAP_COOLDOWN;
+                self.window = 0;
+            }
+        }
+        self.last_sequence = Some(sequence);
+
+        if let Some(latency) = latency_ns {
+            self.latency_ewma_ns = if self.latency_ewma_ns == 0 {
+                latency
+            } else {
+                self.latency_ewma_ns - self.latency_ewma_ns / 8 + latency / 8
+            };
+        }
+
+        self.cooldown = self.cooldown.saturating_sub(1);
+        self.window += 1;
+        if self.cooldown == 0
+            && self.window >= DEPTH_ADJUST_WINDOW
+            && self.latency_ewma_ns > self.target_latency_ns
+            && self.depth > self.min_depth
+        {
+            self.depth -= 1;
+            self.window = 0;
+        }
+
+        self.depth
+    }
+}
+
+/// Shared adaptive-depth state, updated by the completion callback and read on requeue paths.
+struct AdaptiveState {
+    controller: Mutex<AdaptiveQueueDepth>,
+    in_flight: AtomicUsize,
+    /// Cached copy of the controller's depth target, readable without the controller lock.
+    target: AtomicUsize,
+}
+
+/// Preallocated capture engine with automatic requeueing.
+///
+/// Wraps the [FrameBufferAllocator] / [Request] / requeue boilerplate that every capture
+/// application otherwise hand-rolls: on construction all framebuffers of a stream are allocated,
+/// memory mapped and attached to requests, and every completed request is requeued as soon as the
+/// [Frame] handed to the caller is dropped. Steady-state capture performs zero allocations.
+///
+/// Backpressure is drop-oldest: at most `depth` completed frames are held for the consumer, any
+/// older ones are requeued directly from the libcamera thread, so a slow consumer never stalls
+/// the sensor.
+pub struct CaptureLoop<'d> {
+    camera: ActiveCamera<'d>,
+    stream: Stream,
+    shared: Arc<CaptureShared>,
+    /// Keeps buffer mappings alive; buffers themselves are owned by the attached requests.
+    _alloc: FrameBufferAllocator,
+}
+
+struct CaptureShared {
+    queue: Mutex<CaptureQueue>,
+    /// Notified when a completed frame is pushed for delivery.
+    available: Condvar,
+    /// Maximum number of completed frames held for the consumer.
+    depth: usize,
+    /// Number of frames requeued without being delivered because the consumer fell behind.
+    dropped: AtomicU64,
+    /// In-flight depth controller, present for engines built with [CaptureLoop::new_adaptive()].
+    adaptive: Option<AdaptiveState>,
+}
+
+#[derive(Default)]
+struct CaptureQueue {
+    /// Completed requests awaiting delivery to the consumer, oldest first.
+    completed: Vec<Request>,
+    /// Requests that are currently not in flight (initial state, or capture stopped).
+    parked: Vec<Request>,
+    /// Recycled requests held back because the adaptive in-flight target is reached.
+    standby: Vec<Request>,
+}
+
+impl CaptureShared {
+    /// Requeues a recycled request through `queue_fn`, or holds it in standby when the adaptive
+    /// in-flight target is reached.
+    ///
+    /// The check-then-increment is not atomic, so a burst of concurrent recycles can overshoot
+    /// the target by a request; the controller corrects on the following completions.
+    fn requeue_recycled(&self, mut req: Request, queue_fn: impl FnOnce(Request) -> io::Result<()>) {
+        if let Some(adaptive) = &self.adaptive {
+            if adaptive.in_flight.load(Ordering::Relaxed) >= adaptive.target.load(Ordering::Relaxed) {
+                self.queue.lock().unwrap().standby.push(req);
+                return;
+            }
+            adaptive.in_flight.fetch_add(1, Ordering::Relaxed);
+        }
+
+        req.reuse(ReuseFlag::ReuseBuffers);
+        // Queueing can only fail when capture is being stopped, in which case the request is
+        // recovered through the cancelled path of the completion callback.
+        if queue_fn(req).is_err() {
+            if let Some(adaptive) = &self.adaptive {
+                adaptive.in_flight.fetch_sub(1, Ordering::Relaxed);
+            }
+        }
+    }
+}
+
+impl<'d> CaptureLoop<'d> {
+    /// Creates a capture engine for a configured camera stream.
+    ///
+    /// Allocates and memory maps all framebuffers of the stream and attaches each to its own
+    /// request. `depth` is the number of completed frames held for the consumer before the
+    /// drop-oldest policy kicks in; it must be below the allocated buffer count, otherwise all
+    /// buffers can end up waiting on the consumer with none left for the sensor.
+    ///
+    /// The camera must be configured with [ActiveCamera::configure()] beforehand. Capture begins
+    /// with [Self::start()].
+    pub fn new(camera: ActiveCamera<'d>, stream: Stream, depth: usize) -> io::Result<Self> {
+        Self::new_inner(camera, stream, depth, None)
+    }
+
+    /// Creates a capture engine with adaptive in-flight depth control.
+    ///
+    /// Like [Self::new()], but instead of keeping every allocated buffer in flight, the number
+    /// of queued requests follows `controller`, see [AdaptiveQueueDepth]. The controller's
+    /// maximum depth is capped to the allocated buffer count.
+    pub fn new_adaptive(
+        camera: ActiveCamera<'d>,
+        stream: Stream,
+        depth: usize,
+        controller: AdaptiveQueueDepth,
+    ) -> io::Result<Self> {
+        Self::new_inner(camera, stream, depth, Some(controller))
+    }
+
+    fn new_inner(
+        mut camera: ActiveCamera<'d>,
+        stream: Stream,
+        depth: usize,
+        adaptive: Option<AdaptiveQueueDepth>,
+    ) -> io::Result<Self> {
+        let mut alloc = FrameBufferAllocator::new(&camera);
+        let buffers = alloc.alloc(&stream)?;
+
+        let mut parked = Vec::with_capacity(buffers.len());
+        for (i, buffer) in buffers.into_iter().enumerate() {
+            let buffer = MemoryMappedFrameBuffer::new(buffer)?;
+            let mut req = camera
+                .create_request(Some(i as u64))
+                .ok_or(io::ErrorKind::OutOfMemory)?;
+            req.add_buffer(&stream, buffer)?;
+            parked.push(req);
+        }
+
+        let adaptive = adaptive.map(|mut controller| {
+            controller.cap_to_buffers(parked.len());
+            AdaptiveState {
+                target: AtomicUsize::new(controller.depth()),
+                in_flight: AtomicUsize::new(0),
+                controller: Mutex::new(controller),
+            }
+        });
+
+        let shared = Arc::new(CaptureShared {
+            queue: Mutex::new(CaptureQueue {
+                completed: Vec::with_capacity(parked.len()),
+                parked,
+                standby: Vec::new(),
+            }),
+            available: Condvar::new(),
+            depth,
+            dropped: AtomicU64::new(0),
+            adaptive,
+        });
+
+        let cb_shared = shared.clone();
+        let requeuer = camera.requeuer();
+        camera.on_request_completed(move |req| {
+            if req.status() == RequestStatus::Cancelled {
+                // Capture was stopped, keep the request for the next start().
+                cb_shared.queue.lock().unwrap().parked.push(req);
+                return;
+            }
+
+            if let Some(adaptive) = &cb_shared.adaptive {
+                adaptive.in_flight.fetch_sub(1, Ordering::Relaxed);
+
+                // Glass-to-callback latency from the kernel buffer timestamp, which shares
+                // CLOCK_MONOTONIC with monotonic_ns().
+                let latency = req
+                    .metadata()
+                    .get::<controls::SensorTimestamp>()
+                    .ok()
+                    .map(|ts| monotonic_ns().saturating_sub(ts.0 as u64));
+
+                let target = adaptive.controller.lock().unwrap().observe(req.sequence(), latency);
+                adaptive.target.store(target, Ordering::Relaxed);
+            }
+
+            let dropped = {
+                let mut queue = cb_shared.queue.lock().unwrap();
+                queue.completed.push(req);
+                if queue.completed.len() > cb_shared.depth {
+                    Some(queue.completed.remove(0))
+                } else {
+                    None
+                }
+            };
+
+            // Requeue outside of the lock so the consumer is never blocked on libcamera.
+            if let Some(oldest) = dropped {
+                cb_shared.dropped.fetch_add(1, Ordering::Relaxed);
+                // Queueing can only fail when capture is being stopped, in which case the request
+                // is recovered through the cancelled path above on one of the next completions.
+                cb_shared.requeue_recycled(oldest, |r| requeuer.queue(r));
+            }
+
+            // Top up from standby when the depth target grew or a slot freed up.
+            if let Some(adaptive) = &cb_shared.adaptive {
+                while adaptive.in_flight.load(Ordering::Relaxed) < adaptive.target.load(Ordering::Relaxed) {
+                    let Some(standby) = cb_shared.queue.lock().unwrap().standby.pop() else {
+                        break;
+                    };
+                    cb_shared.requeue_recycled(standby, |r| requeuer.queue(r));
+                }
+            }
+
+            cb_shared.available.notify_one();
+        });
+
+        Ok(Self {
+            camera,
+            stream,
+            shared,
+            _alloc: alloc,
+        })
+    }
+
+    /// Starts capture and queues idle requests up to the in-flight target.
+    ///
+    /// Without adaptive depth control all requests are queued; otherwise requests beyond the
+    /// controller's current depth wait in standby.
+    pub fn start(&mut self, controls: Option<ControlListRef>) -> io::Result<()> {
+        self.camera.start(controls)?;
+
+        if let Some(adaptive) = &self.shared.adaptive {
+            adaptive.in_flight.store(0, Ordering::Relaxed);
+            let mut controller = adaptive.controller.lock().unwrap();
+            controller.restart();
+            adaptive.target.store(controller.depth(), Ordering::Relaxed);
+        }
+
+        let parked = core::mem::take(&mut self.shared.queue.lock().unwrap().parked);
+        for mut req in parked {
+            if let Some(adaptive) = &self.shared.adaptive {
+                if adaptive.in_flight.load(Ordering::Relaxed) >= adaptive.target.load(Ordering::Relaxed) {
+                    self.shared.queue.lock().unwrap().standby.push(req);
+                    continue;
+                }
+                adaptive.in_flight.fetch_add(1, Ordering::Relaxed);
+            }
+
+            req.reuse(ReuseFlag::ReuseBuffers);
+            self.camera.queue_request(req)?;
+        }
+
+        Ok(())
+    }
+
+    /// Stops capture.
+    ///
+    /// In-flight requests are cancelled by libcamera and returned to the idle pool, ready for the
+    /// next [Self::start()].
+    pub fn stop(&mut self) -> io::Result<()> {
+        self.camera.stop()?;
+
+        // Undelivered frames will not be consumed anymore, return them to the pool as well,
+        // together with any requests the adaptive controller held in standby.
+        let mut queue = self.shared.queue.lock().unwrap();
+        let completed = core::mem::take(&mut queue.completed);
+        queue.parked.extend(completed);
+        let standby = core::mem::take(&mut queue.standby);
+        queue.parked.extend(standby);
+
+        Ok(())
+    }
+
+    /// Returns the oldest completed frame, if one is available, without blocking.
+    pub fn try_next_frame(&self) -> Option<Frame<'_, 'd>> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        self.take_frame(&mut queue)
+    }
+
+    /// Blocks until a completed frame is available.
+    pub fn next_frame(&self) -> Frame<'_, 'd> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            if let Some(frame) = self.take_frame(&mut queue) {
+                return frame;
+            }
+            queue = self.shared.available.wait(queue).unwrap();
+        }
+    }
+
+    /// Blocks until a completed frame is available or the timeout expires.
+    ///
+    /// Fails with [io::ErrorKind::TimedOut] on timeout.
+    pub fn next_frame_timeout(&self, timeout: Duration) -> io::Result<Frame<'_, 'd>> {
+        let deadline = std::time::Instant::now() + timeout;
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            if let Some(frame) = self.take_frame(&mut queue) {
+                return Ok(frame);
+            }
+
+            let remaining = deadline
+                .checked_duration_since(std::time::Instant::now())
+                .ok_or(io::ErrorKind::TimedOut)?;
+            queue = self.shared.available.wait_timeout(queue, remaining).unwrap().0;
+        }
+    }
+
+    fn take_frame(&self, queue: &mut CaptureQueue) -> Option<Frame<'_, 'd>> {
+        if queue.completed.is_empty() {
+            None
+        } else {
+            Some(Frame {
+                req: Some(queue.completed.remove(0)),
+                engine: self,
+            })
+        }
+    }
+
+    /// Number of frames dropped (requeued without delivery) because the consumer fell behind.
+    pub fn dropped_frames(&self) -> u64 {
+        self.shared.dropped.load(Ordering::Relaxed)
+    }
+
+    /// Current in-flight depth target of the adaptive controller.
+    ///
+    /// [None] for engines built without one.
+    pub fn queue_depth(&self) -> Option<usize> {
+        self.shared.adaptive.as_ref().map(|a| a.target.load(Ordering::Relaxed))
+    }
+
+    /// Total number of missed frames observed by the adaptive controller as sequence gaps.
+    ///
+    /// [None] for engines built without one.
+    pub fn sequence_gaps(&self) -> Option<u64> {
+        self.shared
+            .adaptive
+            .as_ref()
+            .map(|a| a.controller.lock().unwrap().sequence_gaps())
+    }
+
+    /// Camera stream that this engine captures from.
+    pub fn stream(&self) -> &Stream {
+        &self.stream
+    }
+
+    /// The underlying camera, e.g. for inspecting controls.
+    pub fn camera(&self) -> &ActiveCamera<'d> {
+        &self.camera
+    }
+}
+
+/// A zero-copy view of a completed frame, borrowed from [CaptureLoop].
+///
+/// Dereferences to the underlying [Request] for metadata and controls access. Dropping the frame
+/// requeues its request, so buffers return to the sensor without any caller involvement.
+pub struct Frame<'a, 'd> {
+    req: Option<Request>,
+    engine: &'a CaptureLoop<'d>,
+}
+
+impl<'a, 'd> Frame<'a, 'd> {
+    /// Memory mapped framebuffer with the captured frame data.
+    pub fn framebuffer(&self) -> &MemoryMappedFrameBuffer<FrameBuffer> {
+        self.req.as_ref().unwrap().buffer(&self.engine.stream).unwrap()
+    }
+}
+
+impl<'a, 'd> Deref for Frame<'a, 'd> {
+    type Target = Request;
+
+    fn deref(&self) -> &Self::Target {
+        self.req.as_ref().unwrap()
+    }
+}
+
+impl<'a, 'd> Drop for Frame<'a, 'd> {
+    fn drop(&mut self) {
+        let req = self.req.take().unwrap();
+        // Cannot fail: frames borrow the engine, so capture cannot have been stopped while one
+        // was held, and slot capacity exceeds the allocated buffer count.
+        self.engine
+            .shared
+            .requeue_recycled(req, |r| self.engine.camera.queue_request(r));
+    }
+}
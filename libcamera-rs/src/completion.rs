@@ -0,0 +1,164 @@
+use std::{
+    cell::UnsafeCell,
+    collections::VecDeque,
+    io,
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc, Mutex,
+    },
+    task::{Context, Poll},
+};
+
+use crate::{camera::ActiveCamera, request::Request};
+
+/// Capacity of [CompletionRing].
+///
+/// Twice [MAX_IN_FLIGHT_REQUESTS](crate::camera::MAX_IN_FLIGHT_REQUESTS), so the ring only fills
+/// up if completions are left unconsumed while new requests keep being queued.
+const COMPLETION_RING_CAPACITY: usize = 128;
+
+/// Lock-free SPSC ring carrying completed [Request]s from the libcamera thread to the consumer.
+///
+/// [Self::push()] runs in the libcamera camera manager thread, [Self::pop()] on the consumer of
+/// [CompletedRequests]. `head` and `tail` are free-running counters, so `tail - head` is the
+/// number of occupied slots. The waker mutex is only held for the duration of a clone or wake and
+/// is never contended with request queueing.
+pub(crate) struct CompletionRing {
+    slots: [UnsafeCell<Option<Request>>; COMPLETION_RING_CAPACITY],
+    /// Consumer position, written only by [Self::pop()].
+    head: AtomicUsize,
+    /// Producer position, written only by [Self::push()].
+    tail: AtomicUsize,
+    /// Waker of the task blocked on [CompletedRequests::poll_next()], if any.
+    waker: Mutex<Option<std::task::Waker>>,
+}
+
+impl Default for CompletionRing {
+    fn default() -> Self {
+        Self {
+            slots: core::array::from_fn(|_| UnsafeCell::new(None)),
+            head: AtomicUsize::new(0),
+            tail: AtomicUsize::new(0),
+            waker: Mutex::new(None),
+        }
+    }
+}
+
+impl CompletionRing {
+    /// Pushes a completed request and wakes the consumer.
+    ///
+    /// If the consumer has fallen behind by [COMPLETION_RING_CAPACITY] completions, the request
+    /// is dropped instead of blocking the libcamera thread.
+    pub(crate) fn push(&self, req: Request) {
+        let tail = self.tail.load(Ordering::Relaxed);
+        let head = self.head.load(Ordering::Acquire);
+
+        if tail.wrapping_sub(head) < COMPLETION_RING_CAPACITY {
+            // Slot is unoccupied and not visible to the consumer until the tail store below.
+            unsafe { *self.slots[tail % COMPLETION_RING_CAPACITY].get() = Some(req) };
+            self.tail.store(tail.wrapping_add(1), Ordering::Release);
+        }
+
+        if let Some(waker) = self.waker.lock().unwrap().take() {
+            waker.wake();
+        }
+    }
+
+    pub(crate) fn pop(&self) -> Option<Request> {
+        let head = self.head.load(Ordering::Relaxed);
+        if head == self.tail.load(Ordering::Acquire) {
+            return None;
+        }
+
+        // Slot was released by the producer with the tail store.
+        let req = unsafe { (*self.slots[head % COMPLETION_RING_CAPACITY].get()).take() };
+        self.head.store(head.wrapping_add(1), Ordering::Release);
+        req
+    }
+}
+
+/// Slot access is synchronized by the head/tail counters, see [CompletionRing].
+unsafe impl Send for CompletionRing {}
+unsafe impl Sync for CompletionRing {}
+
+/// Asynchronous stream of completed [Request]s.
+///
+/// Obtained from [ActiveCamera::completed_requests()]. Completions are handed over through a
+/// lock-free ring with direct waker signaling, so an async consumer costs a single scheduled
+/// wakeup per frame without any intermediate channels or thread hops.
+///
+/// Works with any executor: use [Self::next()] from async code, or [Self::poll_next()] to
+/// implement `futures::Stream` style adapters on top.
+pub struct CompletedRequests {
+    ring: Arc<CompletionRing>,
+    /// Completions popped out of order by [Self::queue_and_wait()], returned by the next poll.
+    pending: VecDeque<Request>,
+}
+
+impl CompletedRequests {
+    pub(crate) fn new(ring: Arc<CompletionRing>) -> Self {
+        Self {
+            ring,
+            pending: VecDeque::new(),
+        }
+    }
+
+    /// Returns a completed request if one is available, without blocking.
+    pub fn try_next(&mut self) -> Option<Request> {
+        self.pending.pop_front().or_else(|| self.ring.pop())
+    }
+
+    /// Polls for the next completed request, registering the task waker if none is available.
+    pub fn poll_next(&mut self, cx: &mut Context<'_>) -> Poll<Request> {
+        if let Some(req) = self.pending.pop_front() {
+            return Poll::Ready(req);
+        }
+
+        self.poll_ring(cx)
+    }
+
+    /// Polls the ring only, skipping requests deferred by [Self::queue_and_wait()].
+    fn poll_ring(&mut self, cx: &mut Context<'_>) -> Poll<Request> {
+        if let Some(req) = self.ring.pop() {
+            return Poll::Ready(req);
+        }
+
+        let mut waker = self.ring.waker.lock().unwrap();
+        match waker.as_ref() {
+            Some(w) if w.will_wake(cx.waker()) => {}
+            _ => *waker = Some(cx.waker().clone()),
+        }
+        drop(waker);
+
+        // Re-check after registering the waker, a completion could have raced the empty check.
+        match self.ring.pop() {
+            Some(req) => Poll::Ready(req),
+            None => Poll::Pending,
+        }
+    }
+
+    /// Waits for the next completed request.
+    ///
+    /// Waits indefinitely if no requests are in flight.
+    pub async fn next(&mut self) -> Request {
+        std::future::poll_fn(|cx| self.poll_next(cx)).await
+    }
+
+    /// Queues a request and waits for its completion.
+    ///
+    /// Requests are matched by their cookie, so each request passed here must have a unique one.
+    /// Completions of other in-flight requests arriving in the meantime are retained and returned
+    /// by subsequent [Self::next()] calls.
+    pub async fn queue_and_wait(&mut self, camera: &ActiveCamera<'_>, req: Request) -> io::Result<Request> {
+        let cookie = req.cookie();
+        camera.queue_request(req)?;
+
+        loop {
+            let completed = std::future::poll_fn(|cx| self.poll_ring(cx)).await;
+            if completed.cookie() == cookie {
+                return Ok(completed);
+            }
+            self.pending.push_back(completed);
+        }
+    }
+}
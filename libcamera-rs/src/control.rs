@@ -1,12 +1,13 @@
-use std::{marker::PhantomData, ptr::NonNull};
+use std::{io, marker::PhantomData, ptr::NonNull};
 
 use libcamera_sys::*;
 use thiserror::Error;
 
 use crate::{
-    control_value::{ControlValue, ControlValueError},
+    control_value::{ControlValue, ControlValueError, ControlValueRef},
     controls::{self, ControlId},
     properties::{self, PropertyId},
+    utils::Arena,
 };
 
 #[derive(Debug, Error)]
@@ -26,6 +27,28 @@ pub trait ControlEntry:
 pub trait Control: ControlEntry {}
 pub trait Property: ControlEntry {}
 
+/// Control whose data type and element count are known at compile time.
+///
+/// Such controls can be copied directly between libcamera value storage and a `#[repr(C)]`
+/// representation, which allows [ControlListRef::get_fixed()] and [ControlListRef::set_fixed()] to
+/// skip the [ControlValue] enum dispatch and its intermediate `SmallVec` storage.
+///
+/// Implemented by codegen for all fixed-size non-string controls in [controls](crate::controls)
+/// and [properties](crate::properties).
+pub trait FixedSizeControlEntry: ControlEntry {
+    /// `libcamera_control_type` of the value.
+    const TYPE: u32;
+    /// Number of elements stored in the value.
+    const NUM_ELEMENTS: usize;
+    /// Whether libcamera stores the value as an array.
+    const IS_ARRAY: bool;
+    /// Representation matching libcamera value storage byte for byte.
+    type Repr: Copy;
+
+    fn from_repr(repr: Self::Repr) -> Self;
+    fn to_repr(&self) -> Self::Repr;
+}
+
 /// Dynamic Control, which does not have strong typing.
 pub trait DynControlEntry: core::fmt::Debug {
     fn id(&self) -> u32;
@@ -43,19 +66,294 @@ impl<T: ControlEntry> DynControlEntry for T {
 }
 
 pub struct ControlInfoMapRef<'d> {
-    _ptr: NonNull<libcamera_control_info_map_t>,
+    ptr: NonNull<libcamera_control_info_map_t>,
     _phantom: PhantomData<&'d ()>,
 }
 
 impl<'d> ControlInfoMapRef<'d> {
     pub(crate) unsafe fn from_ptr(ptr: NonNull<libcamera_control_info_map_t>) -> Self {
         Self {
-            _ptr: ptr,
+            ptr,
+            _phantom: Default::default(),
+        }
+    }
+
+    /// Number of controls in the map.
+    pub fn len(&self) -> usize {
+        unsafe { libcamera_control_info_map_size(self.ptr.as_ptr()) }
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Returns limits of the control with a given id.
+    ///
+    /// Returns [None] if the camera does not support the control.
+    pub fn get(&self, id: u32) -> Option<ControlInfoRef<'_>> {
+        let info_ptr = unsafe { libcamera_control_info_map_find(self.ptr.as_ptr(), id) };
+        NonNull::new(info_ptr.cast_mut()).map(|p| unsafe { ControlInfoRef::from_ptr(p) })
+    }
+}
+
+impl<'d> IntoIterator for &'d ControlInfoMapRef<'d> {
+    type Item = (u32, ControlInfoRef<'d>);
+
+    type IntoIter = ControlInfoMapRefIterator<'d>;
+
+    fn into_iter(self) -> Self::IntoIter {
+        ControlInfoMapRefIterator {
+            it: NonNull::new(unsafe { libcamera_control_info_map_iter(self.ptr.as_ptr()) }).unwrap(),
             _phantom: Default::default(),
         }
     }
 }
 
+impl<'d> core::fmt::Debug for ControlInfoMapRef<'d> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let mut map = f.debug_map();
+        for (id, info) in self.into_iter() {
+            match ControlId::try_from(id) {
+                Ok(id) => map.entry(&id, &info),
+                // If ControlId is unknown just use u32 as key
+                Err(_) => map.entry(&id, &info),
+            };
+        }
+        map.finish()
+    }
+}
+
+pub struct ControlInfoMapRefIterator<'d> {
+    it: NonNull<libcamera_control_info_map_iter_t>,
+    _phantom: PhantomData<&'d ()>,
+}
+
+impl<'d> Iterator for ControlInfoMapRefIterator<'d> {
+    type Item = (u32, ControlInfoRef<'d>);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if unsafe { libcamera_control_info_map_iter_end(self.it.as_ptr()) } {
+            None
+        } else {
+            let id = unsafe { libcamera_control_info_map_iter_id(self.it.as_ptr()) };
+            let info_ptr =
+                NonNull::new(unsafe { libcamera_control_info_map_iter_info(self.it.as_ptr()).cast_mut() }).unwrap();
+            let info = unsafe { ControlInfoRef::from_ptr(info_ptr) };
+
+            unsafe { libcamera_control_info_map_iter_next(self.it.as_ptr()) };
+
+            Some((id, info))
+        }
+    }
+}
+
+impl<'d> Drop for ControlInfoMapRefIterator<'d> {
+    fn drop(&mut self) {
+        unsafe { libcamera_control_info_map_iter_destroy(self.it.as_ptr()) }
+    }
+}
+
+/// Limits of a single control, i.e. its minimum, maximum and default value.
+pub struct ControlInfoRef<'d> {
+    ptr: NonNull<libcamera_control_info_t>,
+    _phantom: PhantomData<&'d ()>,
+}
+
+impl<'d> ControlInfoRef<'d> {
+    pub(crate) unsafe fn from_ptr(ptr: NonNull<libcamera_control_info_t>) -> Self {
+        Self {
+            ptr,
+            _phantom: Default::default(),
+        }
+    }
+
+    /// Minimum value of the control.
+    pub fn min(&self) -> ControlValue {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_info_min(self.ptr.as_ptr()).cast_mut() }).unwrap();
+        unsafe { ControlValue::read(val_ptr) }.unwrap()
+    }
+
+    /// Maximum value of the control.
+    pub fn max(&self) -> ControlValue {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_info_max(self.ptr.as_ptr()).cast_mut() }).unwrap();
+        unsafe { ControlValue::read(val_ptr) }.unwrap()
+    }
+
+    /// Default value of the control.
+    pub fn def(&self) -> ControlValue {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_info_def(self.ptr.as_ptr()).cast_mut() }).unwrap();
+        unsafe { ControlValue::read(val_ptr) }.unwrap()
+    }
+}
+
+impl<'d> core::fmt::Debug for ControlInfoRef<'d> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ControlInfoRef")
+            .field("min", &self.min())
+            .field("max", &self.max())
+            .field("def", &self.def())
+            .finish()
+    }
+}
+
+/// Limits of a single control stored in a [ControlInfoIndex].
+#[derive(Debug, Clone)]
+pub struct ControlInfoEntry {
+    pub id: u32,
+    pub min: ControlValue,
+    pub max: ControlValue,
+    pub def: ControlValue,
+}
+
+impl ControlInfoEntry {
+    /// Clamps `value` into the `[min, max]` range of this control.
+    ///
+    /// Applies to numeric controls whose limits are scalar; array values are clamped element-wise
+    /// against the scalar bounds. Returns `true` if the value was modified.
+    pub fn clamp(&self, value: &mut ControlValue) -> bool {
+        macro_rules! clamp_variant {
+            ($variant:path) => {
+                if let ($variant(vals), $variant(min), $variant(max)) = (&mut *value, &self.min, &self.max) {
+                    if let ([lo], [hi]) = (min.as_slice(), max.as_slice()) {
+                        let mut changed = false;
+                        for v in vals.iter_mut() {
+                            if *v < *lo {
+                                *v = *lo;
+                                changed = true;
+                            } else if *v > *hi {
+                                *v = *hi;
+                                changed = true;
+                            }
+                        }
+                        return changed;
+                    }
+                }
+            };
+        }
+
+        clamp_variant!(ControlValue::Byte);
+        clamp_variant!(ControlValue::Int32);
+        clamp_variant!(ControlValue::Int64);
+        clamp_variant!(ControlValue::Float);
+
+        false
+    }
+}
+
+/// Flat index of camera control limits for FFI-free per-frame validation.
+///
+/// Looking limits up through [ControlInfoMapRef] costs an FFI call and a `std::map` walk per
+/// control. The index copies all (id, min, max, default) tuples out of the map once into a flat
+/// array sorted by id, so hot-path range checks are a binary search over contiguous memory with
+/// no FFI. Built at [Camera::acquire()](crate::camera::Camera::acquire) time, see
+/// [ActiveCamera::control_index()](crate::camera::ActiveCamera::control_index).
+#[derive(Debug, Clone, Default)]
+pub struct ControlInfoIndex {
+    entries: Vec<ControlInfoEntry>,
+}
+
+impl ControlInfoIndex {
+    /// Builds the index from a control info map.
+    pub fn from_map(map: &ControlInfoMapRef) -> Self {
+        let mut entries: Vec<ControlInfoEntry> = map
+            .into_iter()
+            .map(|(id, info)| ControlInfoEntry {
+                id,
+                min: info.min(),
+                max: info.max(),
+                def: info.def(),
+            })
+            .collect();
+        entries.sort_unstable_by_key(|e| e.id);
+
+        Self { entries }
+    }
+
+    /// Number of controls in the index.
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Returns limits of the control with a given id.
+    pub fn get(&self, id: u32) -> Option<&ControlInfoEntry> {
+        self.entries
+            .binary_search_by_key(&id, |e| e.id)
+            .ok()
+            .map(|i| &self.entries[i])
+    }
+
+    /// Returns whether the camera supports the control with a given id.
+    pub fn contains(&self, id: u32) -> bool {
+        self.entries.binary_search_by_key(&id, |e| e.id).is_ok()
+    }
+
+    /// Clamps `value` into the supported range of the control with a given id.
+    ///
+    /// Returns `true` if the value was modified, see [ControlInfoEntry::clamp()].
+    pub fn clamp(&self, id: u32, value: &mut ControlValue) -> bool {
+        self.get(id).map(|e| e.clamp(value)).unwrap_or(false)
+    }
+
+    /// All entries, sorted by control id.
+    pub fn entries(&self) -> &[ControlInfoEntry] {
+        &self.entries
+    }
+}
+
+/// An owned control list backed by the global camera controls id map.
+///
+/// Lists of requests and cameras are only accessible as [ControlListRef]. An owned list is useful
+/// for assembling control sets ahead of time, e.g. for
+/// [ActiveCamera::start()](crate::camera::ActiveCamera::start), and for exercising control paths
+/// without a camera.
+pub struct ControlList {
+    inner: ControlListRef<'static>,
+}
+
+impl ControlList {
+    pub fn new() -> Self {
+        Self {
+            inner: unsafe { ControlListRef::from_ptr(NonNull::new(libcamera_control_list_create()).unwrap()) },
+        }
+    }
+}
+
+impl Default for ControlList {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl core::ops::Deref for ControlList {
+    type Target = ControlListRef<'static>;
+
+    fn deref(&self) -> &Self::Target {
+        &self.inner
+    }
+}
+
+impl core::ops::DerefMut for ControlList {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.inner
+    }
+}
+
+impl core::fmt::Debug for ControlList {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        self.inner.fmt(f)
+    }
+}
+
+impl Drop for ControlList {
+    fn drop(&mut self) {
+        unsafe { libcamera_control_list_destroy(self.inner.ptr.as_ptr()) }
+    }
+}
+
 pub struct ControlListRef<'d> {
     pub(crate) ptr: NonNull<libcamera_control_list_t>,
     _phantom: PhantomData<&'d ()>,
@@ -85,6 +383,329 @@ impl<'d> ControlListRef<'d> {
         unsafe { ctrl_val.write(val_ptr) };
         Ok(())
     }
+
+    /// Reads a fixed-size control directly from libcamera value storage.
+    ///
+    /// Validates the type and element count once, then copies the value straight into its
+    /// `#[repr(C)]` representation without going through [ControlValue].
+    pub fn get_fixed<C: FixedSizeControlEntry>(&self) -> Result<C, ControlError> {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_list_get(self.ptr.as_ptr(), C::ID as _) })
+            .ok_or(ControlError::NotFound(C::ID))?;
+
+        unsafe { read_fixed(val_ptr) }
+    }
+
+    /// Writes a fixed-size control directly into libcamera value storage.
+    ///
+    /// Single FFI call per control, no intermediate [ControlValue].
+    pub fn set_fixed<C: FixedSizeControlEntry>(&mut self, val: C) -> Result<(), ControlError> {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_list_get(self.ptr.as_ptr(), C::ID as _) })
+            .ok_or(ControlError::NotFound(C::ID))?;
+
+        let repr = val.to_repr();
+        unsafe {
+            libcamera_control_value_set(
+                val_ptr.as_ptr(),
+                C::TYPE,
+                &repr as *const C::Repr as *const _,
+                C::IS_ARRAY,
+                C::NUM_ELEMENTS as _,
+            )
+        };
+        Ok(())
+    }
+
+    /// Copies all controls of `other` that are not yet present into this list in one FFI call.
+    ///
+    /// Follows `ControlList::merge()` semantics: entries that already exist in this list keep
+    /// their value. A persistent base list can thus be combined with a small per-frame delta
+    /// list by writing the deltas first and merging the base on top.
+    pub fn merge(&mut self, other: &ControlListRef) {
+        unsafe { libcamera_control_list_merge(self.ptr.as_ptr(), other.ptr.as_ptr()) };
+    }
+
+    /// Reads a control value without per-value heap allocation, borrowing element storage from
+    /// `arena`.
+    ///
+    /// Array controls read through [Self::get()] spill to the heap for every element count above
+    /// one; a per-frame metadata loop should read through an [Arena] instead and reset it once
+    /// the request is recycled, see [ControlValueRef].
+    pub fn get_ref<'a>(&self, id: u32, arena: &'a Arena) -> Result<ControlValueRef<'a>, ControlError> {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_list_get(self.ptr.as_ptr(), id as _) })
+            .ok_or(ControlError::NotFound(id))?;
+
+        Ok(unsafe { ControlValueRef::read(val_ptr, arena) }?)
+    }
+}
+
+unsafe fn read_fixed<C: FixedSizeControlEntry>(val_ptr: NonNull<libcamera_control_value_t>) -> Result<C, ControlError> {
+    let found = libcamera_control_value_type(val_ptr.as_ptr());
+    if found != C::TYPE {
+        return Err(ControlValueError::InvalidType {
+            expected: C::TYPE,
+            found,
+        }
+        .into());
+    }
+
+    let found = libcamera_control_value_num_elements(val_ptr.as_ptr());
+    if found != C::NUM_ELEMENTS {
+        return Err(ControlValueError::InvalidLength {
+            expected: C::NUM_ELEMENTS,
+            found,
+        }
+        .into());
+    }
+
+    let mut repr = core::mem::MaybeUninit::<C::Repr>::uninit();
+    core::ptr::copy_nonoverlapping(
+        libcamera_control_value_get(val_ptr.as_ptr()) as *const u8,
+        repr.as_mut_ptr() as *mut u8,
+        core::mem::size_of::<C::Repr>(),
+    );
+    Ok(C::from_repr(repr.assume_init()))
+}
+
+/// Flat snapshot of a control list, exported in a single FFI crossing.
+///
+/// Iterating a [ControlListRef] goes through a heap-allocated FFI iterator with three FFI calls
+/// per entry. [Self::capture()] instead walks the list once on the C++ side and writes all
+/// (id, type, value bytes) tuples into reusable buffers, which can then be iterated without any
+/// FFI. Buffers retain their capacity across captures, so per-frame metadata export is
+/// allocation-free in steady state.
+#[derive(Default)]
+pub struct ControlListSnapshot {
+    entries: Vec<libcamera_control_list_export_entry_t>,
+    data: Vec<u8>,
+    /// Number of valid entries after the last capture.
+    len: usize,
+}
+
+impl ControlListSnapshot {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Exports all entries of the control list into the snapshot, replacing previous contents.
+    pub fn capture(&mut self, list: &ControlListRef) {
+        loop {
+            let mut data_used = 0usize;
+            let count = unsafe {
+                libcamera_control_list_export(
+                    list.ptr.as_ptr(),
+                    self.entries.as_mut_ptr(),
+                    self.entries.len() as _,
+                    self.data.as_mut_ptr(),
+                    self.data.len() as _,
+                    &mut data_used,
+                )
+            } as usize;
+
+            if count <= self.entries.len() && data_used <= self.data.len() {
+                self.len = count;
+                return;
+            }
+
+            // Buffers too small (first capture or list grew), grow and retry.
+            self.entries.resize_with(count, || unsafe { core::mem::zeroed() });
+            self.data.resize(data_used, 0);
+        }
+    }
+
+    /// Number of entries in the snapshot.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns (control id, value) of the entry at a given index.
+    pub fn get(&self, index: usize) -> Option<(u32, ControlValue)> {
+        if index >= self.len {
+            return None;
+        }
+
+        let entry = &self.entries[index];
+        let data = self.data[entry.offset as usize..].as_ptr();
+        let val = unsafe { ControlValue::read_raw(entry.type_, entry.num_elements as usize, data.cast()) }.unwrap();
+        Some((entry.id, val))
+    }
+
+    /// Iterates over (control id, value) pairs without crossing FFI.
+    pub fn iter(&self) -> ControlListSnapshotIterator<'_> {
+        ControlListSnapshotIterator {
+            snapshot: self,
+            index: 0,
+        }
+    }
+}
+
+pub struct ControlListSnapshotIterator<'d> {
+    snapshot: &'d ControlListSnapshot,
+    index: usize,
+}
+
+impl<'d> Iterator for ControlListSnapshotIterator<'d> {
+    type Item = (u32, ControlValue);
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let item = self.snapshot.get(self.index)?;
+        self.index += 1;
+        Some(item)
+    }
+}
+
+/// Accumulates control writes and applies them to a [ControlListRef] in a single FFI crossing.
+///
+/// [ControlListRef::set()] performs one FFI call and value conversion per control, which adds up
+/// when many controls are set on every request. The batch serializes all pending values into one
+/// reusable buffer and submits them with a single `libcamera_control_list_set_batch()` call.
+/// Internal buffers retain their capacity across [Self::apply()], so steady-state use is
+/// allocation-free.
+#[derive(Default)]
+pub struct ControlListBatch {
+    entries: Vec<libcamera_control_list_batch_entry_t>,
+    data: Vec<u8>,
+}
+
+impl ControlListBatch {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Adds a control to the batch.
+    ///
+    /// See [controls](crate::controls) for available items.
+    pub fn set<C: Control>(&mut self, val: C) {
+        self.set_raw(C::ID, val.into());
+    }
+
+    /// Adds a control value with an explicit control id to the batch.
+    pub fn set_raw(&mut self, id: u32, val: ControlValue) {
+        let offset = self.data.len();
+        self.data.extend_from_slice(val.raw_bytes());
+
+        self.entries.push(libcamera_control_list_batch_entry_t {
+            id,
+            type_: val.ty(),
+            is_array: val.is_array() as u32,
+            num_elements: val.num_elements() as u32,
+            offset: offset as u32,
+        });
+    }
+
+    /// Number of controls pending in the batch.
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Discards all pending controls, retaining buffer capacity.
+    pub fn clear(&mut self) {
+        self.entries.clear();
+        self.data.clear();
+    }
+
+    /// Writes all pending controls into the control list in one FFI call and clears the batch.
+    pub fn apply(&mut self, list: &mut ControlListRef) -> io::Result<()> {
+        let ret = unsafe {
+            libcamera_control_list_set_batch(
+                list.ptr.as_ptr(),
+                self.entries.as_ptr(),
+                self.entries.len() as _,
+                self.data.as_ptr(),
+            )
+        };
+
+        self.clear();
+
+        if ret < 0 {
+            Err(io::Error::from_raw_os_error(ret))
+        } else {
+            Ok(())
+        }
+    }
+}
+
+/// Persistent control cache that only submits values that actually changed.
+///
+/// Control loops typically re-submit a mostly identical set of ~10 controls on every request,
+/// and each submitted value is re-serialized through libcamera value storage whether it changed
+/// or not. libcamera only needs the deltas: `ControlState` keeps the last-applied value per
+/// control id in a flat sorted array, compares every [Self::set()] against it and stages only
+/// changed values into an internal [ControlListBatch]. In the steady state where nothing
+/// changes, [Self::apply()] is free.
+///
+/// The cache tracks what this instance applied, not what the camera reports, so use one
+/// `ControlState` per camera and call [Self::reset()] after a failed apply or a capture restart
+/// to force full re-submission.
+#[derive(Default)]
+pub struct ControlState {
+    /// Last applied (id, value) pairs, sorted by id.
+    applied: Vec<(u32, ControlValue)>,
+    /// Changed values staged for the next apply.
+    batch: ControlListBatch,
+}
+
+impl ControlState {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Stages a control if its value differs from the last applied one.
+    ///
+    /// See [controls](crate::controls) for available items.
+    pub fn set<C: Control>(&mut self, val: C) {
+        self.set_raw(C::ID, val.into());
+    }
+
+    /// Stages a control value with an explicit control id if it differs from the last applied one.
+    pub fn set_raw(&mut self, id: u32, val: ControlValue) {
+        match self.applied.binary_search_by_key(&id, |&(id, _)| id) {
+            Ok(index) => {
+                // Bitwise comparison: cheap, and unlike PartialEq it does not treat a NaN as a
+                // change on every frame.
+                let prev = &self.applied[index].1;
+                if core::mem::discriminant(prev) == core::mem::discriminant(&val) && prev.raw_bytes() == val.raw_bytes()
+                {
+                    return;
+                }
+                self.batch.set_raw(id, val.clone());
+                self.applied[index].1 = val;
+            }
+            Err(index) => {
+                self.batch.set_raw(id, val.clone());
+                self.applied.insert(index, (id, val));
+            }
+        }
+    }
+
+    /// Number of changed controls staged for the next apply.
+    pub fn pending(&self) -> usize {
+        self.batch.len()
+    }
+
+    /// Writes all staged changes into the control list in one FFI call.
+    ///
+    /// Does nothing when no value changed since the previous apply. On failure the cache no
+    /// longer matches what the camera received, call [Self::reset()] to recover.
+    pub fn apply(&mut self, list: &mut ControlListRef) -> io::Result<()> {
+        if self.batch.is_empty() {
+            return Ok(());
+        }
+        self.batch.apply(list)
+    }
+
+    /// Forgets all applied values, so every control is re-submitted on its next set.
+    pub fn reset(&mut self) {
+        self.applied.clear();
+        self.batch.clear();
+    }
 }
 
 impl<'d> IntoIterator for &'d ControlListRef<'d> {
@@ -147,6 +768,16 @@ impl<'d> PropertyListRef<'d> {
         unsafe { ctrl_val.write(val_ptr) };
         Ok(())
     }
+
+    /// Reads a fixed-size property directly from libcamera value storage.
+    ///
+    /// See [ControlListRef::get_fixed()].
+    pub fn get_fixed<C: FixedSizeControlEntry>(&self) -> Result<C, ControlError> {
+        let val_ptr = NonNull::new(unsafe { libcamera_control_list_get(self.ptr.as_ptr(), C::ID as _) })
+            .ok_or(ControlError::NotFound(C::ID))?;
+
+        unsafe { read_fixed(val_ptr) }
+    }
 }
 
 impl<'d> IntoIterator for &'d PropertyListRef<'d> {
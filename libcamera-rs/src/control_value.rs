@@ -4,7 +4,10 @@ use libcamera_sys::*;
 use smallvec::{smallvec, SmallVec};
 use thiserror::Error;
 
-use crate::geometry::{Rectangle, Size};
+use crate::{
+    geometry::{Rectangle, Size},
+    utils::Arena,
+};
 
 #[derive(Error, Debug)]
 pub enum ControlValueError {
@@ -211,6 +214,16 @@ impl ControlValue {
         let num_elements = unsafe { libcamera_control_value_num_elements(val.as_ptr()) } as usize;
         let data = unsafe { libcamera_control_value_get(val.as_ptr()) };
 
+        Self::read_raw(ty, num_elements, data)
+    }
+
+    /// Parses a value from raw `libcamera::ControlValue` storage, e.g. from an exported
+    /// control list snapshot.
+    pub(crate) unsafe fn read_raw(
+        ty: u32,
+        num_elements: usize,
+        data: *const core::ffi::c_void,
+    ) -> Result<Self, ControlValueError> {
         use libcamera_control_type::*;
         match ty {
             LIBCAMERA_CONTROL_TYPE_NONE => Ok(Self::None),
@@ -277,6 +290,46 @@ impl ControlValue {
         libcamera_control_value_set(val.as_ptr(), self.ty(), data, is_array, len as _);
     }
 
+    /// Number of elements held by the value (string length for [ControlValue::String]).
+    pub fn num_elements(&self) -> usize {
+        match self {
+            ControlValue::None => 0,
+            ControlValue::Bool(v) => v.len(),
+            ControlValue::Byte(v) => v.len(),
+            ControlValue::Int32(v) => v.len(),
+            ControlValue::Int64(v) => v.len(),
+            ControlValue::Float(v) => v.len(),
+            ControlValue::String(v) => v.len(),
+            ControlValue::Rectangle(v) => v.len(),
+            ControlValue::Size(v) => v.len(),
+        }
+    }
+
+    /// Raw value data as it is laid out inside `libcamera::ControlValue` storage.
+    pub(crate) fn raw_bytes(&self) -> &[u8] {
+        let (data, len): (*const u8, usize) = match self {
+            ControlValue::None => (core::ptr::NonNull::dangling().as_ptr(), 0),
+            ControlValue::Bool(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::Byte(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::Int32(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::Int64(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::Float(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::String(v) => (v.as_ptr(), v.len()),
+            ControlValue::Rectangle(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+            ControlValue::Size(v) => (v.as_ptr().cast(), core::mem::size_of_val(v.as_slice())),
+        };
+        unsafe { core::slice::from_raw_parts(data, len) }
+    }
+
+    /// Whether libcamera treats the value as an array, mirroring the logic of [Self::write()].
+    pub(crate) fn is_array(&self) -> bool {
+        if matches!(self, ControlValue::String(_)) {
+            true
+        } else {
+            self.num_elements() != 1
+        }
+    }
+
     pub fn ty(&self) -> u32 {
         use libcamera_control_type::*;
         match self {
@@ -292,3 +345,122 @@ impl ControlValue {
         }
     }
 }
+
+/// A borrowed value of a control or a property, backed by an [Arena].
+///
+/// Reading a [ControlValue] copies every value into a `SmallVec<[T; 1]>`, so any array control
+/// larger than one element (AF windows, colour correction matrices, histogram metadata) spills
+/// to the heap on every read. The borrowed variant bump-allocates element storage from an arena
+/// instead, which the caller resets once per frame when the request is recycled - per-frame
+/// metadata extraction then performs zero individual heap allocations regardless of control
+/// sizes. Obtained from [ControlListRef::get_ref()](crate::control::ControlListRef::get_ref).
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum ControlValueRef<'a> {
+    None,
+    Bool(&'a [bool]),
+    Byte(&'a [u8]),
+    Int32(&'a [i32]),
+    Int64(&'a [i64]),
+    Float(&'a [f32]),
+    String(&'a str),
+    Rectangle(&'a [Rectangle]),
+    Size(&'a [Size]),
+}
+
+impl<'a> ControlValueRef<'a> {
+    pub(crate) unsafe fn read(
+        val: NonNull<libcamera_control_value_t>,
+        arena: &'a Arena,
+    ) -> Result<Self, ControlValueError> {
+        let ty = unsafe { libcamera_control_value_type(val.as_ptr()) };
+        let num_elements = unsafe { libcamera_control_value_num_elements(val.as_ptr()) } as usize;
+        let data = unsafe { libcamera_control_value_get(val.as_ptr()) };
+
+        use libcamera_control_type::*;
+        match ty {
+            LIBCAMERA_CONTROL_TYPE_NONE => Ok(Self::None),
+            LIBCAMERA_CONTROL_TYPE_BOOL => {
+                let slice = core::slice::from_raw_parts(data as *const bool, num_elements);
+                Ok(Self::Bool(arena.alloc_slice(slice)))
+            }
+            LIBCAMERA_CONTROL_TYPE_BYTE => {
+                let slice = core::slice::from_raw_parts(data as *const u8, num_elements);
+                Ok(Self::Byte(arena.alloc_slice(slice)))
+            }
+            LIBCAMERA_CONTROL_TYPE_INT32 => {
+                let slice = core::slice::from_raw_parts(data as *const i32, num_elements);
+                Ok(Self::Int32(arena.alloc_slice(slice)))
+            }
+            LIBCAMERA_CONTROL_TYPE_INT64 => {
+                let slice = core::slice::from_raw_parts(data as *const i64, num_elements);
+                Ok(Self::Int64(arena.alloc_slice(slice)))
+            }
+            LIBCAMERA_CONTROL_TYPE_FLOAT => {
+                let slice = core::slice::from_raw_parts(data as *const f32, num_elements);
+                Ok(Self::Float(arena.alloc_slice(slice)))
+            }
+            LIBCAMERA_CONTROL_TYPE_STRING => {
+                let slice = core::slice::from_raw_parts(data as *const u8, num_elements);
+                Ok(Self::String(arena.alloc_str(core::str::from_utf8(slice).unwrap())))
+            }
+            LIBCAMERA_CONTROL_TYPE_RECTANGLE => {
+                let slice = core::slice::from_raw_parts(data as *const libcamera_rectangle_t, num_elements);
+                Ok(Self::Rectangle(
+                    arena.alloc_slice_fill(num_elements, |i| Rectangle::from(slice[i])),
+                ))
+            }
+            LIBCAMERA_CONTROL_TYPE_SIZE => {
+                let slice = core::slice::from_raw_parts(data as *const libcamera_size_t, num_elements);
+                Ok(Self::Size(
+                    arena.alloc_slice_fill(num_elements, |i| Size::from(slice[i])),
+                ))
+            }
+            _ => Err(ControlValueError::UnknownType(ty)),
+        }
+    }
+
+    /// Number of elements held by the value (string length for [ControlValueRef::String]).
+    pub fn num_elements(&self) -> usize {
+        match self {
+            ControlValueRef::None => 0,
+            ControlValueRef::Bool(v) => v.len(),
+            ControlValueRef::Byte(v) => v.len(),
+            ControlValueRef::Int32(v) => v.len(),
+            ControlValueRef::Int64(v) => v.len(),
+            ControlValueRef::Float(v) => v.len(),
+            ControlValueRef::String(v) => v.len(),
+            ControlValueRef::Rectangle(v) => v.len(),
+            ControlValueRef::Size(v) => v.len(),
+        }
+    }
+
+    pub fn ty(&self) -> u32 {
+        use libcamera_control_type::*;
+        match self {
+            ControlValueRef::None => LIBCAMERA_CONTROL_TYPE_NONE,
+            ControlValueRef::Bool(_) => LIBCAMERA_CONTROL_TYPE_BOOL,
+            ControlValueRef::Byte(_) => LIBCAMERA_CONTROL_TYPE_BYTE,
+            ControlValueRef::Int32(_) => LIBCAMERA_CONTROL_TYPE_INT32,
+            ControlValueRef::Int64(_) => LIBCAMERA_CONTROL_TYPE_INT64,
+            ControlValueRef::Float(_) => LIBCAMERA_CONTROL_TYPE_FLOAT,
+            ControlValueRef::String(_) => LIBCAMERA_CONTROL_TYPE_STRING,
+            ControlValueRef::Rectangle(_) => LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            ControlValueRef::Size(_) => LIBCAMERA_CONTROL_TYPE_SIZE,
+        }
+    }
+
+    /// Owned copy of the value, e.g. to retain a single control beyond the arena reset.
+    pub fn to_owned(&self) -> ControlValue {
+        match *self {
+            ControlValueRef::None => ControlValue::None,
+            ControlValueRef::Bool(v) => ControlValue::Bool(SmallVec::from_slice(v)),
+            ControlValueRef::Byte(v) => ControlValue::Byte(SmallVec::from_slice(v)),
+            ControlValueRef::Int32(v) => ControlValue::Int32(SmallVec::from_slice(v)),
+            ControlValueRef::Int64(v) => ControlValue::Int64(SmallVec::from_slice(v)),
+            ControlValueRef::Float(v) => ControlValue::Float(SmallVec::from_slice(v)),
+            ControlValueRef::String(v) => ControlValue::String(v.to_string()),
+            ControlValueRef::Rectangle(v) => ControlValue::Rectangle(SmallVec::from_slice(v)),
+            ControlValueRef::Size(v) => ControlValue::Size(SmallVec::from_slice(v)),
+        }
+    }
+}
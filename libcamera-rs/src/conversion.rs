@@ -0,0 +1,347 @@
+//! Pixel format conversion kernels operating directly on mapped framebuffer planes.
+//!
+//! Converts captured frames into tightly packed RGB8 in a caller-provided output buffer,
+//! dispatched by [PixelFormat]. The kernels read straight out of
+//! [MemoryMappedFrameBuffer](crate::framebuffer_map::MemoryMappedFrameBuffer) plane slices, so no
+//! intermediate copies are made. The YUV conversion uses AVX2 on x86_64 (detected at runtime) and
+//! NEON on aarch64, falling back to scalar code elsewhere and for row tails.
+//!
+//! All kernels share the same 6-bit fixed point BT.601 coefficients, so scalar and SIMD paths
+//! produce identical output.
+
+use drm_fourcc::DrmFourcc;
+use thiserror::Error;
+
+use crate::{geometry::Size, pixel_format::PixelFormat};
+
+/// `DRM_FORMAT_SBGGR10` from libcamera's drm_fourcc extensions, not part of mainline drm.
+const FOURCC_SBGGR10: u32 = u32::from_le_bytes(*b"BA10");
+/// `MIPI_FORMAT_MOD_CSI2_PACKED` from libcamera's drm_fourcc extensions.
+const MOD_MIPI_CSI2_PACKED: u64 = (0x0b << 56) | 1;
+
+/// NV12: full-res Y plane followed by an interleaved half-res UV plane.
+pub const PIXEL_FORMAT_NV12: PixelFormat = PixelFormat::new(DrmFourcc::Nv12 as u32, 0);
+/// 10-bit BGGR bayer, CSI-2 packed: 4 pixels in 5 bytes.
+pub const PIXEL_FORMAT_SBGGR10_CSI2P: PixelFormat = PixelFormat::new(FOURCC_SBGGR10, MOD_MIPI_CSI2_PACKED);
+
+#[derive(Debug, Error)]
+pub enum ConversionError {
+    #[error("No conversion kernel for pixel format {0:?}")]
+    UnsupportedFormat(PixelFormat),
+    #[error("Image geometry {0}x{1} not supported by the kernel")]
+    UnsupportedGeometry(u32, u32),
+    #[error("Plane {0} is missing")]
+    MissingPlane(usize),
+    #[error("Buffer too small: expected at least {expected} bytes, found {found}")]
+    BufferTooSmall { expected: usize, found: usize },
+}
+
+/// Returns whether [convert_to_rgb()] has a kernel for the given format.
+pub fn supports(format: PixelFormat) -> bool {
+    format == PIXEL_FORMAT_NV12 || format == PIXEL_FORMAT_SBGGR10_CSI2P
+}
+
+/// Converts a captured frame into tightly packed RGB8.
+///
+/// * `format` - Pixel format of the frame, see [supports()] for available kernels.
+/// * `planes` - Mapped plane data of the framebuffer, e.g. from
+///   [MemoryMappedFrameBuffer::data()](crate::framebuffer_map::MemoryMappedFrameBuffer::data).
+/// * `size` - Image size in pixels from the stream configuration.
+/// * `stride` - Line stride of the planes in bytes from the stream configuration.
+/// * `out` - Output buffer of at least `width * height * 3` bytes.
+pub fn convert_to_rgb(
+    format: PixelFormat,
+    planes: &[&[u8]],
+    size: Size,
+    stride: usize,
+    out: &mut [u8],
+) -> Result<(), ConversionError> {
+    let (width, height) = (size.width as usize, size.height as usize);
+
+    let expected = width * height * 3;
+    if out.len() < expected {
+        return Err(ConversionError::BufferTooSmall {
+            expected,
+            found: out.len(),
+        });
+    }
+
+    if format == PIXEL_FORMAT_NV12 {
+        if width % 2 != 0 || height % 2 != 0 {
+            return Err(ConversionError::UnsupportedGeometry(size.width, size.height));
+        }
+
+        let y_plane = check_plane(planes, 0, (height - 1) * stride + width)?;
+        // Single-plane NV12 layouts put the UV data into the same plane after the Y data.
+        let uv_plane = if planes.len() > 1 {
+            check_plane(planes, 1, (height / 2 - 1) * stride + width)?
+        } else {
+            &check_plane(planes, 0, height * stride + (height / 2 - 1) * stride + width)?[height * stride..]
+        };
+
+        nv12_to_rgb(y_plane, uv_plane, width, height, stride, out);
+        Ok(())
+    } else if format == PIXEL_FORMAT_SBGGR10_CSI2P {
+        if width % 4 != 0 || height % 2 != 0 {
+            return Err(ConversionError::UnsupportedGeometry(size.width, size.height));
+        }
+
+        let plane = check_plane(planes, 0, (height - 1) * stride + width / 4 * 5)?;
+        sbggr10p_to_rgb(plane, width, height, stride, out);
+        Ok(())
+    } else {
+        Err(ConversionError::UnsupportedFormat(format))
+    }
+}
+
+fn check_plane<'a>(planes: &[&'a [u8]], index: usize, expected: usize) -> Result<&'a [u8], ConversionError> {
+    let plane = *planes.get(index).ok_or(ConversionError::MissingPlane(index))?;
+    if plane.len() < expected {
+        Err(ConversionError::BufferTooSmall {
+            expected,
+            found: plane.len(),
+        })
+    } else {
+        Ok(plane)
+    }
+}
+
+/// 6-bit fixed point BT.601 limited range coefficients, chosen so that all intermediate values of
+/// the SIMD kernels fit (with saturating adds) into i16:
+/// `R = 1.164 (Y - 16) + 1.596 (V - 128)`, `G = 1.164 (Y - 16) - 0.392 (U - 128) - 0.813 (V - 128)`,
+/// `B = 1.164 (Y - 16) + 2.017 (U - 128)`.
+const COEF_Y: i32 = 74;
+const COEF_RV: i32 = 102;
+const COEF_GU: i32 = 25;
+const COEF_GV: i32 = 52;
+const COEF_BU: i32 = 129;
+const ROUND: i32 = 32;
+
+#[inline]
+fn yuv_to_rgb(y: u8, u: u8, v: u8) -> [u8; 3] {
+    let c = COEF_Y * (y as i32 - 16);
+    let d = u as i32 - 128;
+    let e = v as i32 - 128;
+
+    let r = (c + COEF_RV * e + ROUND) >> 6;
+    let g = (c - COEF_GU * d - COEF_GV * e + ROUND) >> 6;
+    let b = (c + COEF_BU * d + ROUND) >> 6;
+
+    [r.clamp(0, 255) as u8, g.clamp(0, 255) as u8, b.clamp(0, 255) as u8]
+}
+
+/// Converts one row of NV12. `uv_row` starts at the first chroma byte sampled by `y_row`.
+fn nv12_row_scalar(y_row: &[u8], uv_row: &[u8], out: &mut [u8]) {
+    for (x, (dst, y)) in out.chunks_exact_mut(3).zip(y_row).enumerate() {
+        let uv = x & !1;
+        dst.copy_from_slice(&yuv_to_rgb(*y, uv_row[uv], uv_row[uv + 1]));
+    }
+}
+
+fn nv12_to_rgb(y_plane: &[u8], uv_plane: &[u8], width: usize, height: usize, stride: usize, out: &mut [u8]) {
+    #[cfg(target_arch = "x86_64")]
+    let row_fn: fn(&[u8], &[u8], &mut [u8]) = if is_x86_feature_detected!("avx2") {
+        nv12_row_avx2
+    } else {
+        nv12_row_scalar
+    };
+    #[cfg(target_arch = "aarch64")]
+    let row_fn: fn(&[u8], &[u8], &mut [u8]) = nv12_row_neon;
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    let row_fn: fn(&[u8], &[u8], &mut [u8]) = nv12_row_scalar;
+
+    for row in 0..height {
+        let y_row = &y_plane[row * stride..][..width];
+        let uv_row = &uv_plane[(row / 2) * stride..][..width];
+        let out_row = &mut out[row * width * 3..][..width * 3];
+        row_fn(y_row, uv_row, out_row);
+    }
+}
+
+#[cfg(target_arch = "x86_64")]
+fn nv12_row_avx2(y_row: &[u8], uv_row: &[u8], out: &mut [u8]) {
+    // Checked by the caller in nv12_to_rgb().
+    unsafe { nv12_row_avx2_impl(y_row, uv_row, out) }
+}
+
+/// Converts one row of NV12 with 16 pixels per iteration of 16-bit AVX2 arithmetic.
+///
+/// The 48 output bytes per iteration are interleaved through a stack buffer, which the compiler
+/// lowers to shuffles; the arithmetic still dominates the scalar version by a wide margin.
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn nv12_row_avx2_impl(y_row: &[u8], uv_row: &[u8], out: &mut [u8]) {
+    use core::arch::x86_64::*;
+
+    let width = y_row.len();
+
+    // Byte shuffles (within each 128-bit lane) that duplicate the widened U respectively V
+    // element of each pixel pair across both of its pixels.
+    #[rustfmt::skip]
+    let u_shuf = _mm256_setr_epi8(
+        0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13,
+        0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13,
+    );
+    #[rustfmt::skip]
+    let v_shuf = _mm256_setr_epi8(
+        2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15,
+        2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15,
+    );
+
+    let mut x = 0;
+    while x + 16 <= width {
+        let y = _mm256_cvtepu8_epi16(_mm_loadu_si128(y_row.as_ptr().add(x) as *const _));
+        let uv = _mm256_cvtepu8_epi16(_mm_loadu_si128(uv_row.as_ptr().add(x) as *const _));
+
+        let c = _mm256_mullo_epi16(
+            _mm256_sub_epi16(y, _mm256_set1_epi16(16)),
+            _mm256_set1_epi16(COEF_Y as i16),
+        );
+        let d = _mm256_sub_epi16(_mm256_shuffle_epi8(uv, u_shuf), _mm256_set1_epi16(128));
+        let e = _mm256_sub_epi16(_mm256_shuffle_epi8(uv, v_shuf), _mm256_set1_epi16(128));
+
+        let round = _mm256_set1_epi16(ROUND as i16);
+        // Saturating adds: full-range Y together with extreme chroma can overflow i16 by a few
+        // bits, saturation keeps the result clamped exactly like the scalar path.
+        let r = _mm256_srai_epi16::<6>(_mm256_adds_epi16(
+            _mm256_adds_epi16(c, _mm256_mullo_epi16(e, _mm256_set1_epi16(COEF_RV as i16))),
+            round,
+        ));
+        let g = _mm256_srai_epi16::<6>(_mm256_adds_epi16(
+            _mm256_subs_epi16(
+                _mm256_subs_epi16(c, _mm256_mullo_epi16(d, _mm256_set1_epi16(COEF_GU as i16))),
+                _mm256_mullo_epi16(e, _mm256_set1_epi16(COEF_GV as i16)),
+            ),
+            round,
+        ));
+        let b = _mm256_srai_epi16::<6>(_mm256_adds_epi16(
+            _mm256_adds_epi16(c, _mm256_mullo_epi16(d, _mm256_set1_epi16(COEF_BU as i16))),
+            round,
+        ));
+
+        let mut rgb = [[0u8; 16]; 3];
+        for (bytes, chan) in rgb.iter_mut().zip([r, g, b]) {
+            // packus clamps to u8 and duplicates each half within its lane, extract one copy each.
+            let packed = _mm256_packus_epi16(chan, chan);
+            _mm_storel_epi64(bytes.as_mut_ptr() as *mut _, _mm256_castsi256_si128(packed));
+            _mm_storel_epi64(
+                bytes.as_mut_ptr().add(8) as *mut _,
+                _mm256_extracti128_si256::<1>(packed),
+            );
+        }
+
+        for (i, dst) in out[x * 3..][..48].chunks_exact_mut(3).enumerate() {
+            dst[0] = rgb[0][i];
+            dst[1] = rgb[1][i];
+            dst[2] = rgb[2][i];
+        }
+
+        x += 16;
+    }
+
+    // x is even, so the chroma offset of the tail equals its luma offset.
+    nv12_row_scalar(&y_row[x..], &uv_row[x..], &mut out[x * 3..]);
+}
+
+/// Converts one row of NV12 with 16 pixels per iteration of 16-bit NEON arithmetic.
+///
+/// NEON is mandatory on aarch64, so no runtime detection is needed. The interleaved RGB store
+/// maps directly onto `vst3_u8`.
+#[cfg(target_arch = "aarch64")]
+fn nv12_row_neon(y_row: &[u8], uv_row: &[u8], out: &mut [u8]) {
+    use core::arch::aarch64::*;
+
+    #[inline]
+    unsafe fn convert8(y: uint8x8_t, u: uint8x8_t, v: uint8x8_t, out: *mut u8) {
+        let c = vmulq_n_s16(
+            vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y)), vdupq_n_s16(16)),
+            COEF_Y as i16,
+        );
+        let d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128));
+        let e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128));
+
+        let round = vdupq_n_s16(ROUND as i16);
+        // Saturating adds for the same overflow headroom reason as in the AVX2 kernel.
+        let r = vqmovun_s16(vshrq_n_s16::<6>(vqaddq_s16(
+            vqaddq_s16(c, vmulq_n_s16(e, COEF_RV as i16)),
+            round,
+        )));
+        let g = vqmovun_s16(vshrq_n_s16::<6>(vqaddq_s16(
+            vqsubq_s16(
+                vqsubq_s16(c, vmulq_n_s16(d, COEF_GU as i16)),
+                vmulq_n_s16(e, COEF_GV as i16),
+            ),
+            round,
+        )));
+        let b = vqmovun_s16(vshrq_n_s16::<6>(vqaddq_s16(
+            vqaddq_s16(c, vmulq_n_s16(d, COEF_BU as i16)),
+            round,
+        )));
+
+        vst3_u8(out, uint8x8x3_t(r, g, b));
+    }
+
+    let width = y_row.len();
+    let mut x = 0;
+    while x + 16 <= width {
+        unsafe {
+            let y = vld1q_u8(y_row.as_ptr().add(x));
+            // Deinterleave 8 UV pairs, then duplicate each sample across its two pixels.
+            let uv = vld2_u8(uv_row.as_ptr().add(x));
+            let u = vcombine_u8(vzip1_u8(uv.0, uv.0), vzip2_u8(uv.0, uv.0));
+            let v = vcombine_u8(vzip1_u8(uv.1, uv.1), vzip2_u8(uv.1, uv.1));
+
+            let dst = out.as_mut_ptr().add(x * 3);
+            convert8(vget_low_u8(y), vget_low_u8(u), vget_low_u8(v), dst);
+            convert8(vget_high_u8(y), vget_high_u8(u), vget_high_u8(v), dst.add(24));
+        }
+        x += 16;
+    }
+
+    // x is even, so the chroma offset of the tail equals its luma offset.
+    nv12_row_scalar(&y_row[x..], &uv_row[x..], &mut out[x * 3..]);
+}
+
+/// Converts 10-bit CSI-2 packed BGGR bayer data into RGB8 with a 2x2 block demosaic.
+///
+/// The packing stores the 8 MSBs of 4 pixels followed by one byte of their low 2-bit pairs.
+/// Since 8-bit output discards the low bits anyway (`value >> 2` is exactly the high byte),
+/// unpacking reduces to reading 4 of every 5 bytes and no bit manipulation is needed.
+///
+/// Each 2x2 bayer cell (B G / G R) produces one RGB value - red and blue are taken directly and
+/// the two greens are averaged - which is written to all 4 pixels of the cell. This trades
+/// chroma resolution for speed, which suits computer-vision consumers; interpolating demosaics
+/// can be layered on later if image quality ever becomes the bottleneck.
+fn sbggr10p_to_rgb(plane: &[u8], width: usize, height: usize, stride: usize, out: &mut [u8]) {
+    let out_stride = width * 3;
+
+    for by in (0..height).step_by(2) {
+        let row_bg = &plane[by * stride..];
+        let row_gr = &plane[(by + 1) * stride..];
+        let (out_top, out_rest) = out[by * out_stride..].split_at_mut(out_stride);
+        let out_bot = &mut out_rest[..out_stride];
+
+        for bx in (0..width).step_by(4) {
+            // Each packed group of 5 bytes holds 4 pixels.
+            let group = bx / 4 * 5;
+            let bg = &row_bg[group..group + 4];
+            let gr = &row_gr[group..group + 4];
+
+            for cell in 0..2 {
+                let b = bg[cell * 2];
+                let r = gr[cell * 2 + 1];
+                let g = ((bg[cell * 2 + 1] as u16 + gr[cell * 2] as u16) / 2) as u8;
+
+                let px = (bx + cell * 2) * 3;
+                for dst in [&mut out_top[px..px + 6], &mut out_bot[px..px + 6]] {
+                    dst[0] = r;
+                    dst[1] = g;
+                    dst[2] = b;
+                    dst[3] = r;
+                    dst[4] = g;
+                    dst[5] = b;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+use std::{
+    io,
+    os::fd::{AsFd, BorrowedFd, FromRawFd, OwnedFd},
+};
+
+use smallvec::SmallVec;
+
+use crate::{framebuffer::AsFrameBuffer, geometry::Size, pixel_format::PixelFormat, stream::StreamConfigurationRef};
+
+/// Duplicates a file descriptor with `O_CLOEXEC` set.
+fn dup_cloexec(fd: i32) -> io::Result<OwnedFd> {
+    let fd = unsafe { libc::fcntl(fd, libc::F_DUPFD_CLOEXEC, 0) };
+    if fd < 0 {
+        Err(io::Error::last_os_error())
+    } else {
+        Ok(unsafe { OwnedFd::from_raw_fd(fd) })
+    }
+}
+
+/// A single plane of a [DmaBufFrame], owning a duplicate of its dma-buf fd.
+#[derive(Debug)]
+pub struct DmaBufPlane {
+    fd: OwnedFd,
+    offset: usize,
+    len: usize,
+}
+
+impl DmaBufPlane {
+    /// Borrows the dma-buf file descriptor, e.g. to pass it to an ioctl.
+    pub fn fd(&self) -> BorrowedFd<'_> {
+        self.fd.as_fd()
+    }
+
+    /// Detaches and returns the owned dma-buf file descriptor.
+    pub fn into_fd(self) -> OwnedFd {
+        self.fd
+    }
+
+    /// Offset of plane data within the file descriptor.
+    ///
+    /// Multiple planes may share one fd at different offsets.
+    pub fn offset(&self) -> usize {
+        self.offset
+    }
+
+    /// Data length of the plane in bytes.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+}
+
+/// Self-contained dma-buf descriptor of a captured frame.
+///
+/// Packages duplicated plane fds together with the image geometry needed to import the frame
+/// elsewhere (V4L2 M2M encoders, GPU APIs, DRM planes), so completed buffers can travel to
+/// downstream consumers without ever being mapped into this process' address space - unlike
+/// [MemoryMappedFrameBuffer](crate::framebuffer_map::MemoryMappedFrameBuffer), which maps and
+/// therefore forces a CPU copy per consumer.
+///
+/// The fds are duplicates created at export time, so the descriptor remains valid independently
+/// of the originating [FrameBuffer](crate::framebuffer_allocator::FrameBuffer) and [Request](crate::request::Request)
+/// lifetimes. Note that the underlying buffer contents are only guaranteed stable until the
+/// buffer is requeued for capture.
+#[derive(Debug)]
+pub struct DmaBufFrame {
+    planes: SmallVec<[DmaBufPlane; 4]>,
+    size: Size,
+    stride: u32,
+    pixel_format: PixelFormat,
+}
+
+impl DmaBufFrame {
+    /// Exports the planes of a framebuffer as a dma-buf descriptor.
+    ///
+    /// `config` must be the [StreamConfigurationRef] of the stream that the framebuffer was
+    /// allocated for, it supplies the pixel format, size and stride describing the plane layout.
+    ///
+    /// Fails if a plane fd cannot be duplicated, e.g. when the fd limit is reached.
+    pub fn export(fb: &impl AsFrameBuffer, config: &StreamConfigurationRef) -> io::Result<Self> {
+        let mut planes = SmallVec::new();
+
+        for plane in fb.planes().into_iter() {
+            planes.push(DmaBufPlane {
+                fd: dup_cloexec(plane.fd())?,
+                offset: plane.offset().unwrap_or(0),
+                len: plane.len(),
+            });
+        }
+
+        Ok(Self {
+            planes,
+            size: config.get_size(),
+            stride: config.get_stride(),
+            pixel_format: config.get_pixel_format(),
+        })
+    }
+
+    /// Planes of the frame, in framebuffer order.
+    pub fn planes(&self) -> &[DmaBufPlane] {
+        &self.planes
+    }
+
+    /// Consumes the descriptor, returning its planes.
+    pub fn into_planes(self) -> impl Iterator<Item = DmaBufPlane> {
+        self.planes.into_iter()
+    }
+
+    /// Image size in pixels.
+    pub fn size(&self) -> Size {
+        self.size
+    }
+
+    /// Line stride of the image in bytes.
+    pub fn stride(&self) -> u32 {
+        self.stride
+    }
+
+    /// Pixel format of the image.
+    pub fn pixel_format(&self) -> PixelFormat {
+        self.pixel_format
+    }
+}
@@ -0,0 +1,396 @@
+use std::{
+    collections::VecDeque,
+    io,
+    ops::Deref,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    time::Duration,
+};
+
+use crate::{
+    camera::ActiveCamera,
+    control::ControlListRef,
+    framebuffer_allocator::{FrameBuffer, FrameBufferAllocator},
+    framebuffer_map::MemoryMappedFrameBuffer,
+    request::{Request, RequestStatus, ReuseFlag},
+    stream::Stream,
+};
+
+/// Fans a single capture stream out to multiple consumers without copying frames.
+///
+/// A completed [Request] owns the only copy of its framebuffer, so feeding several consumers
+/// (e.g. an encoder, inference and a preview) normally forces a deep copy for all but one of
+/// them. The broker instead wraps every completed request in a reference-counted [SharedFrame]
+/// and hands a clone to each [FrameSubscriber]; the buffer is requeued to the sensor only when
+/// the last reference drops.
+///
+/// Backpressure is per subscriber: each subscription has a lag budget of undelivered frames, and
+/// when a consumer falls behind its oldest pending frame is skipped (the reference is dropped)
+/// instead of stalling the sensor or the other consumers. A frame therefore never waits on the
+/// slowest subscriber, it only skips it.
+///
+/// Dropping the broker blocks until all outstanding [SharedFrame]s are returned, so frames must
+/// not be held on the thread that drops it.
+pub struct FrameBroker<'d> {
+    camera: ActiveCamera<'d>,
+    shared: Arc<BrokerShared>,
+    /// Keeps buffer mappings alive; buffers themselves are owned by the attached requests.
+    _alloc: FrameBufferAllocator,
+}
+
+struct BrokerShared {
+    queue: Mutex<BrokerQueue>,
+    /// Notified when a frame is delivered to any subscriber queue.
+    available: Condvar,
+    /// Notified when an outstanding frame is returned, see [FrameBroker]'s [Drop].
+    returned: Condvar,
+    /// Requeue handle used when the last frame reference drops. Points into the camera owned by
+    /// the broker, which blocks on drop until no frame can use this anymore.
+    requeuer: crate::camera::Requeuer,
+    /// Camera stream the broker captures from.
+    stream: Stream,
+    /// Number of frames completed while no subscriber was active.
+    undelivered: AtomicU64,
+}
+
+#[derive(Default)]
+struct BrokerQueue {
+    /// Per-subscriber delivery queues; [None] marks an unsubscribed slot available for reuse.
+    subscribers: Vec<Option<SubscriberQueue>>,
+    /// Requests that are currently not in flight (initial state, or capture stopped).
+    parked: Vec<Request>,
+    /// Number of live [FrameShared]s whose request has not been returned yet.
+    outstanding: usize,
+    /// Set while capture is stopped: returned frames are parked instead of requeued.
+    stopped: bool,
+}
+
+struct SubscriberQueue {
+    /// Undelivered frames, oldest first.
+    frames: VecDeque<Arc<FrameShared>>,
+    /// Maximum number of undelivered frames before the oldest is skipped.
+    lag_budget: usize,
+    /// Number of frames skipped because the consumer exceeded its lag budget.
+    skipped: u64,
+}
+
+/// Shared ownership node of a completed request; the last reference returns it for requeue.
+struct FrameShared {
+    req: Option<Request>,
+    shared: Arc<BrokerShared>,
+}
+
+// A completed request is inert until it is requeued: every method reachable through a shared
+// [SharedFrame] reference is a const read, and mutation (reuse and requeue) happens only in
+// [Drop] when no other reference exists.
+unsafe impl Sync for FrameShared {}
+
+impl Drop for FrameShared {
+    fn drop(&mut self) {
+        let Some(mut req) = self.req.take() else { return };
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        queue.outstanding -= 1;
+        if queue.stopped {
+            queue.parked.push(req);
+        } else {
+            req.reuse(ReuseFlag::ReuseBuffers);
+            // Queueing under the lock cannot race with stop(): the stopped flag is flipped under
+            // the same lock before the camera is stopped, so a request queued here is either
+            // accepted or cancelled back into the parked pool by the completion callback.
+            let _ = self.shared.requeuer.queue(req);
+        }
+
+        self.shared.returned.notify_all();
+    }
+}
+
+impl<'d> FrameBroker<'d> {
+    /// Creates a frame broker for a configured camera stream.
+    ///
+    /// Allocates and memory maps all framebuffers of the stream and attaches each to its own
+    /// request. The camera must be configured with [ActiveCamera::configure()] beforehand;
+    /// capture begins with [Self::start()].
+    pub fn new(mut camera: ActiveCamera<'d>, stream: Stream) -> io::Result<Self> {
+        let mut alloc = FrameBufferAllocator::new(&camera);
+        let buffers = alloc.alloc(&stream)?;
+
+        let mut parked = Vec::with_capacity(buffers.len());
+        for (i, buffer) in buffers.into_iter().enumerate() {
+            let buffer = MemoryMappedFrameBuffer::new(buffer)?;
+            let mut req = camera
+                .create_request(Some(i as u64))
+                .ok_or(io::ErrorKind::OutOfMemory)?;
+            req.add_buffer(&stream, buffer)?;
+            parked.push(req);
+        }
+
+        let shared = Arc::new(BrokerShared {
+            queue: Mutex::new(BrokerQueue {
+                subscribers: Vec::new(),
+                parked,
+                outstanding: 0,
+                stopped: true,
+            }),
+            available: Condvar::new(),
+            returned: Condvar::new(),
+            requeuer: camera.requeuer(),
+            stream,
+            undelivered: AtomicU64::new(0),
+        });
+
+        let cb_shared = shared.clone();
+        camera.on_request_completed(move |req| {
+            if req.status() == RequestStatus::Cancelled {
+                // Capture was stopped, keep the request for the next start().
+                cb_shared.queue.lock().unwrap().parked.push(req);
+                return;
+            }
+
+            let frame = Arc::new(FrameShared {
+                req: Some(req),
+                shared: cb_shared.clone(),
+            });
+
+            let mut skipped = Vec::new();
+            {
+                let mut queue = cb_shared.queue.lock().unwrap();
+                queue.outstanding += 1;
+
+                let mut delivered = false;
+                for sub in queue.subscribers.iter_mut().flatten() {
+                    sub.frames.push_back(frame.clone());
+                    delivered = true;
+                    if sub.frames.len() > sub.lag_budget {
+                        skipped.push(sub.frames.pop_front().unwrap());
+                        sub.skipped += 1;
+                    }
+                }
+
+                if !delivered {
+                    cb_shared.undelivered.fetch_add(1, Ordering::Relaxed);
+                }
+            }
+
+            // The local and skipped references are dropped outside of the lock: whichever drop
+            // turns out to be the last one requeues the request and takes the queue lock itself.
+            drop(frame);
+            drop(skipped);
+
+            cb_shared.available.notify_all();
+        });
+
+        Ok(Self {
+            camera,
+            shared,
+            _alloc: alloc,
+        })
+    }
+
+    /// Creates a subscription receiving every frame the broker delivers from now on.
+    ///
+    /// `lag_budget` is the number of undelivered frames held for this subscriber (at least 1);
+    /// when exceeded, the oldest pending frame is skipped rather than stalling capture. Budgets
+    /// close to the allocated buffer count can starve the sensor when consumers hold on to their
+    /// frames, since every pending frame pins its buffer.
+    pub fn subscribe(&self, lag_budget: usize) -> FrameSubscriber {
+        let sub = SubscriberQueue {
+            frames: VecDeque::new(),
+            lag_budget: lag_budget.max(1),
+            skipped: 0,
+        };
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        let index = match queue.subscribers.iter().position(|s| s.is_none()) {
+            Some(free) => {
+                queue.subscribers[free] = Some(sub);
+                free
+            }
+            None => {
+                queue.subscribers.push(Some(sub));
+                queue.subscribers.len() - 1
+            }
+        };
+
+        FrameSubscriber {
+            shared: self.shared.clone(),
+            index,
+        }
+    }
+
+    /// Starts capture and queues all idle requests.
+    pub fn start(&mut self, controls: Option<ControlListRef>) -> io::Result<()> {
+        self.camera.start(controls)?;
+
+        let parked = {
+            let mut queue = self.shared.queue.lock().unwrap();
+            queue.stopped = false;
+            core::mem::take(&mut queue.parked)
+        };
+
+        for mut req in parked {
+            req.reuse(ReuseFlag::ReuseBuffers);
+            self.camera.queue_request(req)?;
+        }
+
+        Ok(())
+    }
+
+    /// Stops capture.
+    ///
+    /// In-flight requests are cancelled by libcamera and returned to the idle pool. Frames still
+    /// held by subscribers stay valid and join the pool when their last reference drops, ready
+    /// for the next [Self::start()].
+    pub fn stop(&mut self) -> io::Result<()> {
+        // Flipped before stopping so that frames returned from now on park instead of hitting
+        // the failing requeue path.
+        self.shared.queue.lock().unwrap().stopped = true;
+        self.camera.stop()?;
+
+        // Wake blocked subscribers so next_frame_timeout() callers observe the drained queue.
+        self.shared.available.notify_all();
+        Ok(())
+    }
+
+    /// Number of frames that completed while no subscriber was active.
+    pub fn undelivered_frames(&self) -> u64 {
+        self.shared.undelivered.load(Ordering::Relaxed)
+    }
+
+    /// Camera stream that this broker captures from.
+    pub fn stream(&self) -> &Stream {
+        &self.shared.stream
+    }
+
+    /// The underlying camera, e.g. for inspecting controls.
+    pub fn camera(&self) -> &ActiveCamera<'d> {
+        &self.camera
+    }
+}
+
+impl<'d> Drop for FrameBroker<'d> {
+    fn drop(&mut self) {
+        let _ = self.stop();
+
+        // The requeue handle in the shared state points into the camera; wait until every
+        // outstanding frame has been returned before the camera is dropped.
+        let mut queue = self.shared.queue.lock().unwrap();
+        while queue.outstanding > 0 {
+            queue = self.shared.returned.wait(queue).unwrap();
+        }
+    }
+}
+
+/// A subscription to a [FrameBroker], delivering every completed frame within its lag budget.
+///
+/// Obtained from [FrameBroker::subscribe()] and safe to move to a consumer thread. Dropping the
+/// subscription releases any pending frames and stops further delivery.
+pub struct FrameSubscriber {
+    shared: Arc<BrokerShared>,
+    index: usize,
+}
+
+impl FrameSubscriber {
+    /// Returns the oldest pending frame, if one is available, without blocking.
+    pub fn try_next_frame(&self) -> Option<SharedFrame> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        self.pop(&mut queue)
+    }
+
+    /// Blocks until a frame is available.
+    pub fn next_frame(&self) -> SharedFrame {
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            if let Some(frame) = self.pop(&mut queue) {
+                return frame;
+            }
+            queue = self.shared.available.wait(queue).unwrap();
+        }
+    }
+
+    /// Blocks until a frame is available or the timeout expires.
+    ///
+    /// Fails with [io::ErrorKind::TimedOut] on timeout.
+    pub fn next_frame_timeout(&self, timeout: Duration) -> io::Result<SharedFrame> {
+        let deadline = std::time::Instant::now() + timeout;
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            if let Some(frame) = self.pop(&mut queue) {
+                return Ok(frame);
+            }
+
+            let remaining = deadline
+                .checked_duration_since(std::time::Instant::now())
+                .ok_or(io::ErrorKind::TimedOut)?;
+            queue = self.shared.available.wait_timeout(queue, remaining).unwrap().0;
+        }
+    }
+
+    fn pop(&self, queue: &mut BrokerQueue) -> Option<SharedFrame> {
+        queue.subscribers[self.index]
+            .as_mut()
+            .unwrap()
+            .frames
+            .pop_front()
+            .map(|inner| SharedFrame { inner })
+    }
+
+    /// Number of frames skipped because this subscriber exceeded its lag budget.
+    pub fn skipped_frames(&self) -> u64 {
+        let queue = self.shared.queue.lock().unwrap();
+        queue.subscribers[self.index].as_ref().unwrap().skipped
+    }
+}
+
+impl Drop for FrameSubscriber {
+    fn drop(&mut self) {
+        let released = self.shared.queue.lock().unwrap().subscribers[self.index].take();
+        // Pending references are dropped outside of the lock, they may requeue their requests.
+        drop(released);
+    }
+}
+
+/// A reference-counted read view of a completed frame, delivered by a [FrameSubscriber].
+///
+/// Dereferences to the underlying [Request] for metadata and buffer access, and can be cloned
+/// to extend the view to further pipeline stages. The request is requeued to the sensor once
+/// the last clone across all subscribers drops, so a frame should be released as soon as
+/// processing is done - every held frame pins one framebuffer.
+pub struct SharedFrame {
+    inner: Arc<FrameShared>,
+}
+
+impl SharedFrame {
+    /// Memory mapped framebuffer with the captured frame data.
+    pub fn framebuffer(&self) -> &MemoryMappedFrameBuffer<FrameBuffer> {
+        let req = self.inner.req.as_ref().unwrap();
+        req.buffer(&self.inner.shared.stream).unwrap()
+    }
+}
+
+impl Clone for SharedFrame {
+    fn clone(&self) -> Self {
+        Self {
+            inner: self.inner.clone(),
+        }
+    }
+}
+
+impl Deref for SharedFrame {
+    type Target = Request;
+
+    fn deref(&self) -> &Self::Target {
+        self.inner.req.as_ref().unwrap()
+    }
+}
+
+impl core::fmt::Debug for SharedFrame {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("SharedFrame")
+            .field("req", self.inner.req.as_ref().unwrap())
+            .finish()
+    }
+}
@@ -0,0 +1,438 @@
+use std::{
+    collections::VecDeque,
+    fs::{File, OpenOptions},
+    io,
+    os::unix::{fs::OpenOptionsExt, io::AsRawFd},
+    path::{Path, PathBuf},
+    sync::{
+        atomic::{AtomicBool, AtomicU64, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    thread::JoinHandle,
+};
+
+use crate::dmabuf::{DmaBufFrame, DmaBufPlane};
+
+/// Alignment required by `O_DIRECT` for buffer addresses, file offsets and write lengths.
+///
+/// 512 is the traditional logical block size, but NVMe namespaces are commonly formatted with
+/// 4K blocks and the page size bounds dma-buf mapping alignment anyway, so align to 4K.
+const DIRECT_ALIGN: usize = 4096;
+
+/// Copy chunk for plane data whose address is not `O_DIRECT` aligned, see `write_body()`.
+const SCRATCH_CHUNK: usize = 1 << 20;
+
+/// Asynchronous raw-frame disk writer stage.
+///
+/// Recording RAW bursts through `File::write_all` of mapped plane data pushes every frame
+/// through the page cache and blocks the processing thread for the duration. `FrameWriter`
+/// moves the writes to dedicated threads fed from a bounded submission queue, and writes with
+/// `O_DIRECT` so frame data goes to disk without a page-cache copy.
+///
+/// Jobs are [DmaBufFrame] descriptors (see [DmaBufFrame::export()]), so submission transfers
+/// plane fds, not pixels: a writer maps each plane read-only, writes the aligned body of the
+/// mapping directly and passes only sub-block residue at plane boundaries through a small
+/// aligned scratch buffer, then truncates the file to the exact frame size. Filesystems that
+/// reject `O_DIRECT` fall back to buffered writes per file.
+///
+/// The buffer behind a dma-buf frame is only stable until it is requeued for capture, so the
+/// per-job `done` callback is the point to recycle the originating request.
+pub struct FrameWriter {
+    shared: Arc<WriterShared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+struct WriteJob {
+    path: PathBuf,
+    frame: DmaBufFrame,
+    /// Invoked on the writer thread with the number of bytes written.
+    done: Box<dyn FnOnce(io::Result<u64>) + Send>,
+}
+
+struct WriterShared {
+    queue: Mutex<VecDeque<WriteJob>>,
+    /// Submission queue bound; submitters block (or fail, for try_submit) above it.
+    depth: usize,
+    /// Notified when a job is pushed or shutdown is requested.
+    available: Condvar,
+    /// Notified when a job is taken, unblocking a submitter waiting for space.
+    space: Condvar,
+    shutdown: AtomicBool,
+    written_bytes: AtomicU64,
+    failed: AtomicU64,
+}
+
+impl FrameWriter {
+    /// Creates a writer stage with `writers` threads and a submission queue of `depth` jobs.
+    ///
+    /// One writer saturates most NVMe devices; more only help when frames are small relative to
+    /// the device's optimal transfer size. `depth` bounds the number of frames (and thus camera
+    /// buffers) waiting for the disk.
+    pub fn new(writers: usize, depth: usize) -> Self {
+        let shared = Arc::new(WriterShared {
+            queue: Mutex::new(VecDeque::with_capacity(depth)),
+            depth: depth.max(1),
+            available: Condvar::new(),
+            space: Condvar::new(),
+            shutdown: AtomicBool::new(false),
+            written_bytes: AtomicU64::new(0),
+            failed: AtomicU64::new(0),
+        });
+
+        let workers = (0..writers.max(1))
+            .map(|_| {
+                let shared = shared.clone();
+                std::thread::spawn(move || writer_loop(&shared))
+            })
+            .collect();
+
+        Self { shared, workers }
+    }
+
+    /// Submits a frame for writing, blocking while the submission queue is full.
+    ///
+    /// `done` runs on the writer thread once the file is complete (or failed) and is the point
+    /// to requeue the request whose buffer backs the frame.
+    pub fn submit<F>(&self, path: impl Into<PathBuf>, frame: DmaBufFrame, done: F)
+    where
+        F: FnOnce(io::Result<u64>) + Send + 'static,
+    {
+        let mut queue = self.shared.queue.lock().unwrap();
+        while queue.len() >= self.shared.depth {
+            queue = self.shared.space.wait(queue).unwrap();
+        }
+        queue.push_back(WriteJob {
+            path: path.into(),
+            frame,
+            done: Box::new(done),
+        });
+        drop(queue);
+
+        self.shared.available.notify_one();
+    }
+
+    /// Submits a frame for writing without blocking.
+    ///
+    /// When the submission queue is full the job is handed back, so the caller can drop the
+    /// frame (skipping the write) instead of stalling the capture path.
+    #[allow(clippy::type_complexity)]
+    pub fn try_submit<F>(
+        &self,
+        path: impl Into<PathBuf>,
+        frame: DmaBufFrame,
+        done: F,
+    ) -> Result<(), (PathBuf, DmaBufFrame, F)>
+    where
+        F: FnOnce(io::Result<u64>) + Send + 'static,
+    {
+        let path = path.into();
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        if queue.len() >= self.shared.depth {
+            return Err((path, frame, done));
+        }
+        queue.push_back(WriteJob {
+            path,
+            frame,
+            done: Box::new(done),
+        });
+        drop(queue);
+
+        self.shared.available.notify_one();
+        Ok(())
+    }
+
+    /// Number of jobs waiting in the submission queue.
+    pub fn pending(&self) -> usize {
+        self.shared.queue.lock().unwrap().len()
+    }
+
+    /// Total number of bytes written to disk.
+    pub fn written_bytes(&self) -> u64 {
+        self.shared.written_bytes.load(Ordering::Relaxed)
+    }
+
+    /// Number of jobs that failed; the per-job error is reported through the `done` callback.
+    pub fn failed_jobs(&self) -> u64 {
+        self.shared.failed.load(Ordering::Relaxed)
+    }
+}
+
+impl Drop for FrameWriter {
+    /// Flushes: writers finish all submitted jobs before the stage shuts down.
+    fn drop(&mut self) {
+        {
+            let _queue = self.shared.queue.lock().unwrap();
+            self.shared.shutdown.store(true, Ordering::Release);
+            self.shared.available.notify_all();
+        }
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+    }
+}
+
+fn writer_loop(shared: &WriterShared) {
+    let mut scratch = AlignedScratch::new(SCRATCH_CHUNK);
+
+    loop {
+        let job = {
+            let mut queue = shared.queue.lock().unwrap();
+            loop {
+                if let Some(job) = queue.pop_front() {
+                    break job;
+                }
+                if shared.shutdown.load(Ordering::Acquire) {
+                    return;
+                }
+                queue = shared.available.wait(queue).unwrap();
+            }
+        };
+        shared.space.notify_one();
+
+        let result = write_frame(&mut scratch, &job.path, &job.frame);
+        match &result {
+            Ok(bytes) => {
+                shared.written_bytes.fetch_add(*bytes, Ordering::Relaxed);
+            }
+            Err(_) => {
+                shared.failed.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+        (job.done)(result);
+    }
+}
+
+/// Writes all planes of a frame back to back into a file, returning the byte count.
+fn write_frame(scratch: &mut AlignedScratch, path: &Path, frame: &DmaBufFrame) -> io::Result<u64> {
+    // O_DIRECT bypasses the page cache, so an 18MB RAW frame costs one DMA to disk instead of a
+    // memcpy into cache plus writeback. Filesystems without O_DIRECT support report EINVAL at
+    // open, fall back to buffered writes there.
+    let (file, direct) = match OpenOptions::new()
+        .write(true)
+        .create(true)
+        .truncate(true)
+        .custom_flags(libc::O_DIRECT)
+        .open(path)
+    {
+        Ok(file) => (file, true),
+        Err(e) if e.raw_os_error() == Some(libc::EINVAL) => (
+            OpenOptions::new().write(true).create(true).truncate(true).open(path)?,
+            false,
+        ),
+        Err(e) => return Err(e),
+    };
+
+    let mut writer = DirectWriter {
+        file: &file,
+        direct,
+        offset: 0,
+        carry: 0,
+        scratch,
+    };
+
+    for plane in frame.planes() {
+        let map = PlaneMapping::new(plane)?;
+        writer.write(map.data())?;
+    }
+    let total = writer.finish()?;
+
+    // The final block was zero-padded for alignment, cut the file back to the exact frame size.
+    if direct {
+        let ret = unsafe { libc::ftruncate64(file.as_raw_fd(), total as i64) };
+        if ret < 0 {
+            return Err(io::Error::last_os_error());
+        }
+    }
+
+    Ok(total)
+}
+
+/// Read-only mapping of one dma-buf plane.
+struct PlaneMapping {
+    addr: *mut core::ffi::c_void,
+    map_len: usize,
+    /// Plane data offset within the mapping (mmap offsets must be page aligned).
+    delta: usize,
+    len: usize,
+}
+
+impl PlaneMapping {
+    fn new(plane: &DmaBufPlane) -> io::Result<Self> {
+        let page_mask = DIRECT_ALIGN - 1;
+        let map_off = plane.offset() & !page_mask;
+        let delta = plane.offset() - map_off;
+        let map_len = delta + plane.len();
+
+        let addr = unsafe {
+            libc::mmap64(
+                core::ptr::null_mut(),
+                map_len,
+                libc::PROT_READ,
+                libc::MAP_SHARED,
+                plane.fd().as_raw_fd(),
+                map_off as libc::off64_t,
+            )
+        };
+        if addr == libc::MAP_FAILED {
+            return Err(io::Error::last_os_error());
+        }
+
+        Ok(Self {
+            addr,
+            map_len,
+            delta,
+            len: plane.len(),
+        })
+    }
+
+    fn data(&self) -> &[u8] {
+        unsafe { core::slice::from_raw_parts(self.addr.cast::<u8>().add(self.delta), self.len) }
+    }
+}
+
+impl Drop for PlaneMapping {
+    fn drop(&mut self) {
+        unsafe { libc::munmap(self.addr, self.map_len) };
+    }
+}
+
+/// Streams byte slices into a file while upholding the `O_DIRECT` alignment contract.
+///
+/// The file offset is kept block aligned at all times: block-sized multiples of aligned input
+/// are written directly from the source mapping, and residue at plane boundaries accumulates in
+/// an aligned carry buffer until a full block is available. Only sub-block residue and
+/// unaligned source addresses are ever copied.
+struct DirectWriter<'a> {
+    file: &'a File,
+    direct: bool,
+    offset: u64,
+    /// Bytes accumulated in the scratch carry block, always below [DIRECT_ALIGN].
+    carry: usize,
+    scratch: &'a mut AlignedScratch,
+}
+
+impl<'a> DirectWriter<'a> {
+    fn write(&mut self, mut data: &[u8]) -> io::Result<()> {
+        if !self.direct {
+            pwrite_all(self.file, data, self.offset)?;
+            self.offset += data.len() as u64;
+            return Ok(());
+        }
+
+        // Top up a partial carry block first so the file offset stays aligned.
+        if self.carry > 0 {
+            let take = (DIRECT_ALIGN - self.carry).min(data.len());
+            self.scratch.carry_mut()[self.carry..self.carry + take].copy_from_slice(&data[..take]);
+            self.carry += take;
+            data = &data[take..];
+
+            if self.carry == DIRECT_ALIGN {
+                pwrite_all(self.file, &self.scratch.carry_mut()[..DIRECT_ALIGN], self.offset)?;
+                self.offset += DIRECT_ALIGN as u64;
+                self.carry = 0;
+            }
+        }
+
+        let body = data.len() & !(DIRECT_ALIGN - 1);
+        if body > 0 {
+            self.write_body(&data[..body])?;
+            data = &data[body..];
+        }
+
+        self.scratch.carry_mut()[..data.len()].copy_from_slice(data);
+        self.carry = data.len();
+        Ok(())
+    }
+
+    /// Writes a block-aligned amount of data at the aligned file offset.
+    fn write_body(&mut self, data: &[u8]) -> io::Result<()> {
+        if data.as_ptr() as usize % DIRECT_ALIGN == 0 {
+            // The source mapping itself satisfies O_DIRECT, write straight from it.
+            pwrite_all(self.file, data, self.offset)?;
+            self.offset += data.len() as u64;
+        } else {
+            // Source address unaligned (plane offset not a multiple of the block size), stage
+            // through the aligned scratch in large chunks.
+            for chunk in data.chunks(self.scratch.chunk_len()) {
+                let staged = &mut self.scratch.chunk_mut()[..chunk.len()];
+                staged.copy_from_slice(chunk);
+                pwrite_all(self.file, staged, self.offset)?;
+                self.offset += chunk.len() as u64;
+            }
+        }
+        Ok(())
+    }
+
+    /// Flushes the remaining carry, zero-padded to a full block, and returns the exact size.
+    fn finish(&mut self) -> io::Result<u64> {
+        let total = self.offset + self.carry as u64;
+        if self.carry > 0 {
+            self.scratch.carry_mut()[self.carry..].fill(0);
+            pwrite_all(self.file, &self.scratch.carry_mut()[..DIRECT_ALIGN], self.offset)?;
+            self.carry = 0;
+        }
+        Ok(total)
+    }
+}
+
+fn pwrite_all(file: &File, mut data: &[u8], mut offset: u64) -> io::Result<()> {
+    while !data.is_empty() {
+        let ret = unsafe {
+            libc::pwrite64(
+                file.as_raw_fd(),
+                data.as_ptr().cast(),
+                data.len(),
+                offset as libc::off64_t,
+            )
+        };
+        if ret < 0 {
+            let err = io::Error::last_os_error();
+            if err.kind() == io::ErrorKind::Interrupted {
+                continue;
+            }
+            return Err(err);
+        }
+        data = &data[ret as usize..];
+        offset += ret as u64;
+    }
+    Ok(())
+}
+
+/// Block-aligned scratch storage: one carry block plus one large staging chunk.
+struct AlignedScratch {
+    storage: Vec<u8>,
+    chunk_len: usize,
+}
+
+impl AlignedScratch {
+    fn new(chunk_len: usize) -> Self {
+        Self {
+            storage: vec![0; DIRECT_ALIGN + chunk_len + DIRECT_ALIGN],
+            chunk_len,
+        }
+    }
+
+    /// Offset of the first block-aligned byte within the storage.
+    fn base(&self) -> usize {
+        let addr = self.storage.as_ptr() as usize;
+        ((addr + DIRECT_ALIGN - 1) & !(DIRECT_ALIGN - 1)) - addr
+    }
+
+    /// Aligned carry block of [DIRECT_ALIGN] bytes.
+    fn carry_mut(&mut self) -> &mut [u8] {
+        let base = self.base();
+        &mut self.storage[base..base + DIRECT_ALIGN]
+    }
+
+    /// Aligned staging chunk for unaligned source data.
+    fn chunk_mut(&mut self) -> &mut [u8] {
+        let base = self.base() + DIRECT_ALIGN;
+        let len = self.chunk_len;
+        &mut self.storage[base..base + len]
+    }
+
+    fn chunk_len(&self) -> usize {
+        self.chunk_len
+    }
+}
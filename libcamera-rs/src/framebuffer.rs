@@ -15,6 +15,43 @@ pub enum FrameMetadataStatus {
 
 pub type FrameMetadataPlane = libcamera_frame_metadata_plane_t;
 
+/// Plain-data copy of framebuffer metadata.
+///
+/// Obtained from [FrameMetadataRef::snapshot()] in a single FFI call without any allocations,
+/// unlike the individual accessors which cross FFI per field and allocate for plane info.
+#[derive(Clone, Copy)]
+pub struct FrameMetadataSnapshot(libcamera_frame_metadata_snapshot_t);
+
+impl FrameMetadataSnapshot {
+    pub fn status(&self) -> FrameMetadataStatus {
+        FrameMetadataStatus::try_from(self.0.status).unwrap()
+    }
+
+    pub fn sequence(&self) -> u32 {
+        self.0.sequence
+    }
+
+    pub fn timestamp(&self) -> u64 {
+        self.0.timestamp
+    }
+
+    /// Per-plane metadata of the capture.
+    pub fn planes(&self) -> &[FrameMetadataPlane] {
+        &self.0.planes[..self.0.num_planes as usize]
+    }
+}
+
+impl core::fmt::Debug for FrameMetadataSnapshot {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("FrameMetadataSnapshot")
+            .field("status", &self.status())
+            .field("sequence", &self.sequence())
+            .field("timestamp", &self.timestamp())
+            .field("planes", &self.planes())
+            .finish()
+    }
+}
+
 pub struct FrameMetadataPlanes {
     pub(crate) ptr: NonNull<libcamera_frame_metadata_planes_t>,
 }
@@ -121,15 +158,27 @@ impl<'d> FrameMetadataRef<'d> {
             FrameMetadataPlanes::from_ptr(NonNull::new(libcamera_frame_metadata_planes(self.ptr.as_ptr())).unwrap())
         }
     }
+
+    /// Reads status, sequence, timestamp and plane metadata in a single FFI call.
+    ///
+    /// Prefer this over the individual accessors in per-frame code paths.
+    pub fn snapshot(&self) -> FrameMetadataSnapshot {
+        let mut raw = core::mem::MaybeUninit::<libcamera_frame_metadata_snapshot_t>::zeroed();
+        unsafe {
+            libcamera_frame_metadata_read(self.ptr.as_ptr(), raw.as_mut_ptr());
+            FrameMetadataSnapshot(raw.assume_init())
+        }
+    }
 }
 
 impl<'d> core::fmt::Debug for FrameMetadataRef<'d> {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        let snapshot = self.snapshot();
         f.debug_struct("FrameMetadataRef")
-            .field("status", &self.status())
-            .field("sequence", &self.sequence())
-            .field("timestamp", &self.timestamp())
-            .field("planes", &self.planes())
+            .field("status", &snapshot.status())
+            .field("sequence", &snapshot.sequence())
+            .field("timestamp", &snapshot.timestamp())
+            .field("planes", &snapshot.planes())
             .finish()
     }
 }
@@ -1,5 +1,4 @@
-use std::collections::HashMap;
-
+use smallvec::SmallVec;
 use thiserror::Error;
 
 use crate::framebuffer::AsFrameBuffer;
@@ -17,7 +16,177 @@ pub enum MemoryMappedFrameBufferError {
     MemoryMapError(std::io::Error),
 }
 
-struct MappedPlane {
+/// Protection mode of a memory mapped framebuffer.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum MapMode {
+    /// CPU reads the buffer (e.g. consuming captured frames).
+    Read,
+    /// CPU writes the buffer (e.g. filling buffers for an output device).
+    Write,
+    /// CPU both reads and writes the buffer.
+    ReadWrite,
+}
+
+impl MapMode {
+    fn prot(self) -> i32 {
+        match self {
+            MapMode::Read => libc::PROT_READ,
+            MapMode::Write => libc::PROT_WRITE,
+            MapMode::ReadWrite => libc::PROT_READ | libc::PROT_WRITE,
+        }
+    }
+
+    fn dma_buf_sync_flags(self) -> u64 {
+        match self {
+            MapMode::Read => DMA_BUF_SYNC_READ,
+            MapMode::Write => DMA_BUF_SYNC_WRITE,
+            MapMode::ReadWrite => DMA_BUF_SYNC_READ | DMA_BUF_SYNC_WRITE,
+        }
+    }
+}
+
+/// Options controlling how a framebuffer is memory mapped, see
+/// [MemoryMappedFrameBuffer::new_with_options()].
+///
+/// By default pages of a mapping are faulted in lazily on first access, so the first frame read
+/// out of every capture buffer pays a page fault per touched page. Buffers that are mapped
+/// during the allocation phase can afford to pre-fault instead, keeping first-frame latency
+/// indistinguishable from steady state.
+#[derive(Debug, Clone, Copy)]
+pub struct MapOptions {
+    mode: MapMode,
+    populate: bool,
+    locked: bool,
+    sequential: bool,
+    will_need: bool,
+}
+
+impl MapOptions {
+    pub fn new(mode: MapMode) -> Self {
+        Self {
+            mode,
+            populate: false,
+            locked: false,
+            sequential: false,
+            will_need: false,
+        }
+    }
+
+    /// Pre-faults all pages of the mapping at map time (`MAP_POPULATE`).
+    pub fn populate(mut self) -> Self {
+        self.populate = true;
+        self
+    }
+
+    /// Locks the mapped pages into RAM (`MAP_LOCKED`), so they can neither be reclaimed nor
+    /// swapped out afterwards. Implies pre-faulting. Mapping fails if the `RLIMIT_MEMLOCK`
+    /// budget is exceeded.
+    pub fn locked(mut self) -> Self {
+        self.locked = true;
+        self
+    }
+
+    /// Hints sequential access to the mapping (`MADV_SEQUENTIAL`), enabling aggressive
+    /// read-ahead. A good fit for frame consumers that walk the planes top to bottom.
+    pub fn sequential(mut self) -> Self {
+        self.sequential = true;
+        self
+    }
+
+    /// Hints that the mapping will be accessed soon (`MADV_WILLNEED`), starting read-ahead
+    /// without blocking like [Self::populate()] does.
+    pub fn will_need(mut self) -> Self {
+        self.will_need = true;
+        self
+    }
+
+    fn map_flags(&self) -> i32 {
+        let mut flags = libc::MAP_SHARED;
+        if self.populate {
+            flags |= libc::MAP_POPULATE;
+        }
+        if self.locked {
+            flags |= libc::MAP_LOCKED;
+        }
+        flags
+    }
+
+    /// Applies the madvise hints to a fresh mapping. Best effort: hints are performance
+    /// advice only and e.g. not all of them apply to every dma-buf exporter.
+    fn advise(&self, addr: *mut core::ffi::c_void, len: usize) {
+        if self.sequential {
+            unsafe { libc::madvise(addr, len, libc::MADV_SEQUENTIAL) };
+        }
+        if self.will_need {
+            unsafe { libc::madvise(addr, len, libc::MADV_WILLNEED) };
+        }
+    }
+}
+
+impl From<MapMode> for MapOptions {
+    fn from(mode: MapMode) -> Self {
+        Self::new(mode)
+    }
+}
+
+// From linux/dma-buf.h, not exposed by the libc crate.
+const DMA_BUF_SYNC_READ: u64 = 1 << 0;
+const DMA_BUF_SYNC_WRITE: u64 = 2 << 0;
+const DMA_BUF_SYNC_START: u64 = 0 << 2;
+const DMA_BUF_SYNC_END: u64 = 1 << 2;
+/// `_IOW('b', 0, struct dma_buf_sync)`
+const DMA_BUF_IOCTL_SYNC: libc::c_ulong = 0x4008_6200;
+
+#[repr(C)]
+struct dma_buf_sync {
+    flags: u64,
+}
+
+fn dma_buf_sync(fd: i32, flags: u64) -> std::io::Result<()> {
+    let sync = dma_buf_sync { flags };
+    let ret = unsafe { libc::ioctl(fd, DMA_BUF_IOCTL_SYNC, &sync) };
+    if ret < 0 {
+        let err = std::io::Error::last_os_error();
+        // Not all framebuffer fds are dma-bufs (e.g. udmabuf or shm based pipelines),
+        // in which case cache maintenance is not needed and the ioctl is a no-op.
+        if err.raw_os_error() == Some(libc::ENOTTY) {
+            Ok(())
+        } else {
+            Err(err)
+        }
+    } else {
+        Ok(())
+    }
+}
+
+/// Brackets a CPU access window of a [MemoryMappedFrameBuffer] with `DMA_BUF_SYNC_START` /
+/// `DMA_BUF_SYNC_END` ioctls on the underlying dma-buf fds.
+///
+/// On non-coherent platforms this performs the necessary cache maintenance exactly around
+/// the window in which the CPU touches the buffer. Created by
+/// [MemoryMappedFrameBuffer::sync_access()], access is ended when the guard is dropped.
+pub struct DmaBufSyncGuard<'d> {
+    mmaps: &'d [Mmap],
+    flags: u64,
+}
+
+impl<'d> Drop for DmaBufSyncGuard<'d> {
+    fn drop(&mut self) {
+        for mmap in self.mmaps {
+            // Best effort, errors cannot be propagated out of drop.
+            let _ = dma_buf_sync(mmap.fd, self.flags | DMA_BUF_SYNC_END);
+        }
+    }
+}
+
+/// A single active memory mapping, shared by all planes that live within the same file descriptor.
+struct Mmap {
+    fd: i32,
+    ptr: *const core::ffi::c_void,
+    len: usize,
+}
+
+struct PlaneInfo {
     fd: i32,
     offset: usize,
     len: usize,
@@ -26,45 +195,76 @@ struct MappedPlane {
 /// FrameBuffer wrapper, which exposes internal file descriptors as memory mapped [&[u8]] plane slices.
 pub struct MemoryMappedFrameBuffer<T: AsFrameBuffer> {
     fb: T,
-    mmaps: HashMap<i32, (*const core::ffi::c_void, usize)>,
-    planes: Vec<MappedPlane>,
+    mode: MapMode,
+    /// Active mappings, sorted by fd. Planes are sub-ranges of these.
+    mmaps: SmallVec<[Mmap; 4]>,
+    /// Plane geometry, retained for mutable plane access.
+    plane_info: SmallVec<[PlaneInfo; 4]>,
+    /// Plane data slices, precomputed at construction time so that [Self::data()] performs
+    /// no allocations or lookups. Slices point into `mmaps` and are only handed out with
+    /// the lifetime of `&self`.
+    planes: SmallVec<[&'static [u8]; 4]>,
 }
 
 impl<T: AsFrameBuffer> MemoryMappedFrameBuffer<T> {
-    /// Memory map framebuffer, which implements [AsFrameBuffer].
+    /// Memory map framebuffer read-only, which implements [AsFrameBuffer].
     ///
     /// This might fail if framebuffer has invalid plane sizes/offsets or if [libc::mmap] fails itself.
     pub fn new(fb: T) -> Result<Self, MemoryMappedFrameBufferError> {
+        Self::new_with_mode(fb, MapMode::Read)
+    }
+
+    /// Memory map framebuffer with an explicit [MapMode].
+    ///
+    /// Use [MapMode::Write] or [MapMode::ReadWrite] to obtain writable plane access
+    /// through [Self::plane_mut()].
+    pub fn new_with_mode(fb: T, mode: MapMode) -> Result<Self, MemoryMappedFrameBufferError> {
+        Self::new_with_options(fb, MapOptions::new(mode))
+    }
+
+    /// Memory map framebuffer with explicit [MapOptions].
+    ///
+    /// Use e.g. `MapOptions::new(MapMode::Read).populate()` to pre-fault all pages of a capture
+    /// buffer at allocation time, so the first frame does not pay lazy page fault costs.
+    pub fn new_with_options(fb: T, options: MapOptions) -> Result<Self, MemoryMappedFrameBufferError> {
+        let mode = options.mode;
         struct MapInfo {
+            fd: i32,
             /// Maximum offset used by data planes
             mapped_len: usize,
             /// Total file descriptor size
             total_len: usize,
         }
 
-        let mut planes = Vec::new();
-        let mut map_info: HashMap<i32, MapInfo> = HashMap::new();
+        let mut plane_info: SmallVec<[PlaneInfo; 4]> = SmallVec::new();
+        // Sorted by fd, so that plane slices can be resolved with a binary search.
+        let mut map_info: SmallVec<[MapInfo; 4]> = SmallVec::new();
 
         for (index, plane) in fb.planes().into_iter().enumerate() {
             let fd = plane.fd();
             let offset = plane.offset().unwrap();
             let len = plane.len();
 
-            planes.push(MappedPlane { fd, offset, len });
+            plane_info.push(PlaneInfo { fd, offset, len });
 
             // Find total FD length if not known yet
-            if !map_info.contains_key(&fd) {
-                let total_len = unsafe { libc::lseek64(fd, 0, libc::SEEK_END) } as usize;
-                map_info.insert(
-                    fd,
-                    MapInfo {
-                        mapped_len: 0,
-                        total_len,
-                    },
-                );
-            }
+            let pos = match map_info.binary_search_by_key(&fd, |info| info.fd) {
+                Ok(pos) => pos,
+                Err(pos) => {
+                    let total_len = unsafe { libc::lseek64(fd, 0, libc::SEEK_END) } as usize;
+                    map_info.insert(
+                        pos,
+                        MapInfo {
+                            fd,
+                            mapped_len: 0,
+                            total_len,
+                        },
+                    );
+                    pos
+                }
+            };
 
-            let info = map_info.get_mut(&fd).unwrap();
+            let info = &mut map_info[pos];
 
             if offset + len > info.total_len {
                 return Err(MemoryMappedFrameBufferError::PlaneOutOfBounds {
@@ -78,43 +278,101 @@ impl<T: AsFrameBuffer> MemoryMappedFrameBuffer<T> {
             info.mapped_len = info.mapped_len.max(offset + len);
         }
 
-        let mmaps = map_info
-            .iter()
-            .map(|(fd, info)| {
-                let addr = unsafe {
-                    libc::mmap64(
-                        core::ptr::null_mut(),
-                        info.mapped_len,
-                        libc::PROT_READ,
-                        libc::MAP_SHARED,
-                        *fd,
-                        0,
-                    )
-                };
-
-                if addr == libc::MAP_FAILED {
-                    Err(MemoryMappedFrameBufferError::MemoryMapError(
-                        std::io::Error::last_os_error(),
-                    ))
-                } else {
-                    Ok((*fd, (addr.cast_const(), info.mapped_len)))
+        let mut mmaps: SmallVec<[Mmap; 4]> = SmallVec::new();
+        for info in &map_info {
+            let addr = unsafe {
+                libc::mmap64(
+                    core::ptr::null_mut(),
+                    info.mapped_len,
+                    mode.prot(),
+                    options.map_flags(),
+                    info.fd,
+                    0,
+                )
+            };
+
+            if addr == libc::MAP_FAILED {
+                for mmap in mmaps {
+                    unsafe { libc::munmap(mmap.ptr.cast_mut(), mmap.len) };
                 }
-            })
-            .collect::<Result<HashMap<i32, (*const core::ffi::c_void, usize)>, MemoryMappedFrameBufferError>>()
-            .unwrap();
+                return Err(MemoryMappedFrameBufferError::MemoryMapError(
+                    std::io::Error::last_os_error(),
+                ));
+            }
 
-        Ok(Self { fb, mmaps, planes })
-    }
+            options.advise(addr, info.mapped_len);
 
-    /// Returns data slice for each plane within the framebuffer.
-    pub fn data(&self) -> Vec<&[u8]> {
-        self.planes
+            mmaps.push(Mmap {
+                fd: info.fd,
+                ptr: addr.cast_const(),
+                len: info.mapped_len,
+            });
+        }
+
+        // Precompute plane slices, mappings and plane geometry are fixed from here on.
+        let planes = plane_info
             .iter()
             .map(|plane| {
-                let mmap_ptr: *const u8 = self.mmaps[&plane.fd].0.cast();
-                unsafe { core::slice::from_raw_parts(mmap_ptr.offset(plane.offset as _), plane.len) }
+                let pos = mmaps.binary_search_by_key(&plane.fd, |mmap| mmap.fd).unwrap();
+                let mmap_ptr: *const u8 = mmaps[pos].ptr.cast();
+                unsafe { core::slice::from_raw_parts(mmap_ptr.add(plane.offset), plane.len) }
             })
-            .collect()
+            .collect();
+
+        Ok(Self {
+            fb,
+            mode,
+            mmaps,
+            plane_info,
+            planes,
+        })
+    }
+
+    /// Mode that the framebuffer was mapped with.
+    pub fn mode(&self) -> MapMode {
+        self.mode
+    }
+
+    /// Returns data slices for each plane within the framebuffer.
+    ///
+    /// Slices are precomputed at construction time, so this performs no allocations,
+    /// lookups or FFI calls.
+    pub fn data(&self) -> &[&[u8]] {
+        &self.planes
+    }
+
+    /// Returns a mutable data slice for the plane at a given index.
+    ///
+    /// Returns [None] if the index is out of range or the framebuffer was not mapped with
+    /// [MapMode::Write] or [MapMode::ReadWrite].
+    pub fn plane_mut(&mut self, index: usize) -> Option<&mut [u8]> {
+        if self.mode == MapMode::Read {
+            return None;
+        }
+
+        let plane = self.plane_info.get(index)?;
+        let pos = self.mmaps.binary_search_by_key(&plane.fd, |mmap| mmap.fd).unwrap();
+        let mmap_ptr: *mut u8 = self.mmaps[pos].ptr.cast_mut().cast();
+        Some(unsafe { core::slice::from_raw_parts_mut(mmap_ptr.add(plane.offset), plane.len) })
+    }
+
+    /// Begins a CPU access window, bracketing it with dma-buf sync ioctls.
+    ///
+    /// On non-coherent platforms CPU caches must be invalidated before reading and cleaned
+    /// after writing a buffer that the device accesses via DMA. Keep the returned guard alive
+    /// for exactly as long as the CPU touches the plane data - cache maintenance is then only
+    /// paid for the access window instead of being left to the kernel at map/unmap time.
+    ///
+    /// The sync direction is derived from the [MapMode] the buffer was mapped with.
+    pub fn sync_access(&self) -> std::io::Result<DmaBufSyncGuard<'_>> {
+        let flags = self.mode.dma_buf_sync_flags();
+        for mmap in &self.mmaps {
+            dma_buf_sync(mmap.fd, flags | DMA_BUF_SYNC_START)?;
+        }
+        Ok(DmaBufSyncGuard {
+            mmaps: &self.mmaps,
+            flags,
+        })
     }
 }
 
@@ -129,9 +387,9 @@ unsafe impl<T: AsFrameBuffer> Send for MemoryMappedFrameBuffer<T> {}
 impl<T: AsFrameBuffer> Drop for MemoryMappedFrameBuffer<T> {
     fn drop(&mut self) {
         // Unmap
-        for (_fd, (ptr, size)) in self.mmaps.drain() {
+        for mmap in &self.mmaps {
             unsafe {
-                libc::munmap(ptr.cast_mut(), size);
+                libc::munmap(mmap.ptr.cast_mut(), mmap.len);
             }
         }
     }
@@ -1,9 +1,10 @@
 //! Generated by `cargo run --bin generate_rust controls`
 
-use crate::control::{Control, ControlEntry, DynControlEntry};
+use crate::control::{Control, ControlEntry, DynControlEntry, FixedSizeControlEntry};
 use crate::control_value::{ControlValue, ControlValueError};
 #[allow(unused_imports)]
 use crate::geometry::{Rectangle, Size};
+use libcamera_sys::libcamera_control_type;
 use num_enum::{IntoPrimitive, TryFromPrimitive};
 use std::ops::{Deref, DerefMut};
 
@@ -376,6 +377,117 @@ pub enum ControlId {
     TestPatternMode = 48,
 }
 
+impl ControlId {
+    /// Returns the libcamera name, without crossing FFI.
+    pub fn name(self) -> &'static str {
+        match self {
+            Self::AeEnable => "AeEnable",
+            Self::AeLocked => "AeLocked",
+            Self::AeMeteringMode => "AeMeteringMode",
+            Self::AeConstraintMode => "AeConstraintMode",
+            Self::AeExposureMode => "AeExposureMode",
+            Self::ExposureValue => "ExposureValue",
+            Self::ExposureTime => "ExposureTime",
+            Self::AnalogueGain => "AnalogueGain",
+            Self::Brightness => "Brightness",
+            Self::Contrast => "Contrast",
+            Self::Lux => "Lux",
+            Self::AwbEnable => "AwbEnable",
+            Self::AwbMode => "AwbMode",
+            Self::AwbLocked => "AwbLocked",
+            Self::ColourGains => "ColourGains",
+            Self::ColourTemperature => "ColourTemperature",
+            Self::Saturation => "Saturation",
+            Self::SensorBlackLevels => "SensorBlackLevels",
+            Self::Sharpness => "Sharpness",
+            Self::FocusFoM => "FocusFoM",
+            Self::ColourCorrectionMatrix => "ColourCorrectionMatrix",
+            Self::ScalerCrop => "ScalerCrop",
+            Self::DigitalGain => "DigitalGain",
+            Self::FrameDuration => "FrameDuration",
+            Self::FrameDurationLimits => "FrameDurationLimits",
+            Self::SensorTemperature => "SensorTemperature",
+            Self::SensorTimestamp => "SensorTimestamp",
+            Self::AfMode => "AfMode",
+            Self::AfRange => "AfRange",
+            Self::AfSpeed => "AfSpeed",
+            Self::AfMetering => "AfMetering",
+            Self::AfWindows => "AfWindows",
+            Self::AfTrigger => "AfTrigger",
+            Self::AfPause => "AfPause",
+            Self::LensPosition => "LensPosition",
+            Self::AfState => "AfState",
+            Self::AfPauseState => "AfPauseState",
+            Self::AePrecaptureTrigger => "AePrecaptureTrigger",
+            Self::NoiseReductionMode => "NoiseReductionMode",
+            Self::ColorCorrectionAberrationMode => "ColorCorrectionAberrationMode",
+            Self::AeState => "AeState",
+            Self::AwbState => "AwbState",
+            Self::SensorRollingShutterSkew => "SensorRollingShutterSkew",
+            Self::LensShadingMapMode => "LensShadingMapMode",
+            Self::SceneFlicker => "SceneFlicker",
+            Self::PipelineDepth => "PipelineDepth",
+            Self::MaxLatency => "MaxLatency",
+            Self::TestPatternMode => "TestPatternMode",
+        }
+    }
+
+    /// Returns the data type of the value as one of the
+    /// [libcamera_control_type](libcamera_sys::libcamera_control_type) constants, without crossing FFI.
+    pub fn data_type(self) -> u32 {
+        match self {
+            Self::AeEnable => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL,
+            Self::AeLocked => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL,
+            Self::AeMeteringMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AeConstraintMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AeExposureMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::ExposureValue => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::ExposureTime => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AnalogueGain => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::Brightness => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::Contrast => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::Lux => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::AwbEnable => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL,
+            Self::AwbMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AwbLocked => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL,
+            Self::ColourGains => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::ColourTemperature => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::Saturation => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::SensorBlackLevels => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::Sharpness => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::FocusFoM => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::ColourCorrectionMatrix => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::ScalerCrop => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            Self::DigitalGain => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::FrameDuration => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64,
+            Self::FrameDurationLimits => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64,
+            Self::SensorTemperature => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::SensorTimestamp => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64,
+            Self::AfMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfRange => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfSpeed => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfMetering => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfWindows => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            Self::AfTrigger => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfPause => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::LensPosition => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::AfState => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AfPauseState => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AePrecaptureTrigger => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::NoiseReductionMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::ColorCorrectionAberrationMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AeState => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::AwbState => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::SensorRollingShutterSkew => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64,
+            Self::LensShadingMapMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::SceneFlicker => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::PipelineDepth => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::MaxLatency => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::TestPatternMode => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+        }
+    }
+}
+
 /// Enable or disable the AE.
 ///
 /// \sa ExposureTime AnalogueGain
@@ -414,6 +526,21 @@ impl ControlEntry for AeEnable {
     const ID: u32 = ControlId::AeEnable as _;
 }
 
+impl FixedSizeControlEntry for AeEnable {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = bool;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for AeEnable {}
 
 /// Report the lock status of a running AE algorithm.
@@ -458,6 +585,21 @@ impl ControlEntry for AeLocked {
     const ID: u32 = ControlId::AeLocked as _;
 }
 
+impl FixedSizeControlEntry for AeLocked {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = bool;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for AeLocked {}
 
 /// Specify a metering mode for the AE algorithm to use. The metering
@@ -611,6 +753,21 @@ impl ControlEntry for ExposureValue {
     const ID: u32 = ControlId::ExposureValue as _;
 }
 
+impl FixedSizeControlEntry for ExposureValue {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ExposureValue {}
 
 /// Exposure time (shutter speed) for the frame applied in the sensor
@@ -662,6 +819,21 @@ impl ControlEntry for ExposureTime {
     const ID: u32 = ControlId::ExposureTime as _;
 }
 
+impl FixedSizeControlEntry for ExposureTime {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ExposureTime {}
 
 /// Analogue gain value applied in the sensor device.
@@ -714,6 +886,21 @@ impl ControlEntry for AnalogueGain {
     const ID: u32 = ControlId::AnalogueGain as _;
 }
 
+impl FixedSizeControlEntry for AnalogueGain {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for AnalogueGain {}
 
 /// Specify a fixed brightness parameter. Positive values (up to 1.0)
@@ -754,6 +941,21 @@ impl ControlEntry for Brightness {
     const ID: u32 = ControlId::Brightness as _;
 }
 
+impl FixedSizeControlEntry for Brightness {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for Brightness {}
 
 /// Specify a fixed contrast parameter. Normal contrast is given by the
@@ -793,6 +995,21 @@ impl ControlEntry for Contrast {
     const ID: u32 = ControlId::Contrast as _;
 }
 
+impl FixedSizeControlEntry for Contrast {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for Contrast {}
 
 /// Report an estimate of the current illuminance level in lux. The Lux
@@ -832,6 +1049,21 @@ impl ControlEntry for Lux {
     const ID: u32 = ControlId::Lux as _;
 }
 
+impl FixedSizeControlEntry for Lux {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for Lux {}
 
 /// Enable or disable the AWB.
@@ -872,6 +1104,21 @@ impl ControlEntry for AwbEnable {
     const ID: u32 = ControlId::AwbEnable as _;
 }
 
+impl FixedSizeControlEntry for AwbEnable {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = bool;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for AwbEnable {}
 
 /// Specify the range of illuminants to use for the AWB algorithm. The modes
@@ -958,6 +1205,21 @@ impl ControlEntry for AwbLocked {
     const ID: u32 = ControlId::AwbLocked as _;
 }
 
+impl FixedSizeControlEntry for AwbLocked {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_BOOL;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = bool;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for AwbLocked {}
 
 /// Pair of gain values for the Red and Blue colour channels, in that
@@ -1000,6 +1262,21 @@ impl ControlEntry for ColourGains {
     const ID: u32 = ControlId::ColourGains as _;
 }
 
+impl FixedSizeControlEntry for ColourGains {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 2;
+    const IS_ARRAY: bool = true;
+    type Repr = [f32; 2];
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ColourGains {}
 
 /// Report the current estimate of the colour temperature, in kelvin, for this frame. The ColourTemperature control can only be returned in metadata.
@@ -1038,6 +1315,21 @@ impl ControlEntry for ColourTemperature {
     const ID: u32 = ControlId::ColourTemperature as _;
 }
 
+impl FixedSizeControlEntry for ColourTemperature {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ColourTemperature {}
 
 /// Specify a fixed saturation parameter. Normal saturation is given by
@@ -1078,6 +1370,21 @@ impl ControlEntry for Saturation {
     const ID: u32 = ControlId::Saturation as _;
 }
 
+impl FixedSizeControlEntry for Saturation {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for Saturation {}
 
 /// Reports the sensor black levels used for processing a frame, in the
@@ -1119,6 +1426,21 @@ impl ControlEntry for SensorBlackLevels {
     const ID: u32 = ControlId::SensorBlackLevels as _;
 }
 
+impl FixedSizeControlEntry for SensorBlackLevels {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 4;
+    const IS_ARRAY: bool = true;
+    type Repr = [i32; 4];
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for SensorBlackLevels {}
 
 /// A value of 0.0 means no sharpening. The minimum value means
@@ -1164,6 +1486,21 @@ impl ControlEntry for Sharpness {
     const ID: u32 = ControlId::Sharpness as _;
 }
 
+impl FixedSizeControlEntry for Sharpness {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for Sharpness {}
 
 /// Reports a Figure of Merit (FoM) to indicate how in-focus the frame is.
@@ -1208,6 +1545,21 @@ impl ControlEntry for FocusFoM {
     const ID: u32 = ControlId::FocusFoM as _;
 }
 
+impl FixedSizeControlEntry for FocusFoM {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for FocusFoM {}
 
 /// The 3x3 matrix that converts camera RGB to sRGB within the
@@ -1250,6 +1602,21 @@ impl ControlEntry for ColourCorrectionMatrix {
     const ID: u32 = ControlId::ColourCorrectionMatrix as _;
 }
 
+impl FixedSizeControlEntry for ColourCorrectionMatrix {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 9;
+    const IS_ARRAY: bool = true;
+    type Repr = [[f32; 3]; 3];
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ColourCorrectionMatrix {}
 
 /// Sets the image portion that will be scaled to form the whole of
@@ -1296,6 +1663,21 @@ impl ControlEntry for ScalerCrop {
     const ID: u32 = ControlId::ScalerCrop as _;
 }
 
+impl FixedSizeControlEntry for ScalerCrop {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = Rectangle;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for ScalerCrop {}
 
 /// Digital gain value applied during the processing steps applied
@@ -1346,6 +1728,21 @@ impl ControlEntry for DigitalGain {
     const ID: u32 = ControlId::DigitalGain as _;
 }
 
+impl FixedSizeControlEntry for DigitalGain {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for DigitalGain {}
 
 /// The instantaneous frame duration from start of frame exposure to start
@@ -1386,6 +1783,21 @@ impl ControlEntry for FrameDuration {
     const ID: u32 = ControlId::FrameDuration as _;
 }
 
+impl FixedSizeControlEntry for FrameDuration {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i64;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for FrameDuration {}
 
 /// The minimum and maximum (in that order) frame duration,
@@ -1454,6 +1866,21 @@ impl ControlEntry for FrameDurationLimits {
     const ID: u32 = ControlId::FrameDurationLimits as _;
 }
 
+impl FixedSizeControlEntry for FrameDurationLimits {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64;
+    const NUM_ELEMENTS: usize = 2;
+    const IS_ARRAY: bool = true;
+    type Repr = [i64; 2];
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for FrameDurationLimits {}
 
 /// Temperature measure from the camera sensor in Celsius. This is typically
@@ -1497,6 +1924,21 @@ impl ControlEntry for SensorTemperature {
     const ID: u32 = ControlId::SensorTemperature as _;
 }
 
+impl FixedSizeControlEntry for SensorTemperature {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for SensorTemperature {}
 
 /// The time when the first row of the image sensor active array is exposed.
@@ -1544,6 +1986,21 @@ impl ControlEntry for SensorTimestamp {
     const ID: u32 = ControlId::SensorTimestamp as _;
 }
 
+impl FixedSizeControlEntry for SensorTimestamp {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i64;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for SensorTimestamp {}
 
 /// Control to set the mode of the AF (autofocus) algorithm.
@@ -1911,6 +2368,21 @@ impl ControlEntry for LensPosition {
     const ID: u32 = ControlId::LensPosition as _;
 }
 
+impl FixedSizeControlEntry for LensPosition {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for LensPosition {}
 
 /// Reports the current state of the AF algorithm in conjunction with the
@@ -2240,6 +2712,21 @@ impl ControlEntry for SensorRollingShutterSkew {
     const ID: u32 = ControlId::SensorRollingShutterSkew as _;
 }
 
+impl FixedSizeControlEntry for SensorRollingShutterSkew {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT64;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i64;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for SensorRollingShutterSkew {}
 
 /// Control to report if the lens shading map is available. Currently
@@ -2349,6 +2836,21 @@ impl ControlEntry for PipelineDepth {
     const ID: u32 = ControlId::PipelineDepth as _;
 }
 
+impl FixedSizeControlEntry for PipelineDepth {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for PipelineDepth {}
 
 /// The maximum number of frames that can occur after a request (different
@@ -2391,6 +2893,21 @@ impl ControlEntry for MaxLatency {
     const ID: u32 = ControlId::MaxLatency as _;
 }
 
+impl FixedSizeControlEntry for MaxLatency {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Control for MaxLatency {}
 
 /// Control to select the test pattern mode. Currently identical to
@@ -1,9 +1,10 @@
 //! Generated by `cargo run --bin generate_rust properties`
 
-use crate::control::{ControlEntry, DynControlEntry, Property};
+use crate::control::{ControlEntry, DynControlEntry, FixedSizeControlEntry, Property};
 use crate::control_value::{ControlValue, ControlValueError};
 #[allow(unused_imports)]
 use crate::geometry::{Rectangle, Size};
+use libcamera_sys::libcamera_control_type;
 use num_enum::{IntoPrimitive, TryFromPrimitive};
 use std::ops::{Deref, DerefMut};
 
@@ -714,6 +715,41 @@ pub enum PropertyId {
     ColorFilterArrangement = 10,
 }
 
+impl PropertyId {
+    /// Returns the libcamera name, without crossing FFI.
+    pub fn name(self) -> &'static str {
+        match self {
+            Self::Location => "Location",
+            Self::Rotation => "Rotation",
+            Self::Model => "Model",
+            Self::UnitCellSize => "UnitCellSize",
+            Self::PixelArraySize => "PixelArraySize",
+            Self::PixelArrayOpticalBlackRectangles => "PixelArrayOpticalBlackRectangles",
+            Self::PixelArrayActiveAreas => "PixelArrayActiveAreas",
+            Self::ScalerCropMaximum => "ScalerCropMaximum",
+            Self::SensorSensitivity => "SensorSensitivity",
+            Self::ColorFilterArrangement => "ColorFilterArrangement",
+        }
+    }
+
+    /// Returns the data type of the value as one of the
+    /// [libcamera_control_type](libcamera_sys::libcamera_control_type) constants, without crossing FFI.
+    pub fn data_type(self) -> u32 {
+        match self {
+            Self::Location => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::Rotation => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+            Self::Model => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_STRING,
+            Self::UnitCellSize => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_SIZE,
+            Self::PixelArraySize => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_SIZE,
+            Self::PixelArrayOpticalBlackRectangles => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            Self::PixelArrayActiveAreas => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            Self::ScalerCropMaximum => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE,
+            Self::SensorSensitivity => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT,
+            Self::ColorFilterArrangement => libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32,
+        }
+    }
+}
+
 /// Camera mounting location
 #[derive(Debug, Clone, Copy, Eq, PartialEq, TryFromPrimitive, IntoPrimitive)]
 #[repr(i32)]
@@ -1173,6 +1209,21 @@ impl ControlEntry for Rotation {
     const ID: u32 = PropertyId::Rotation as _;
 }
 
+impl FixedSizeControlEntry for Rotation {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_INT32;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = i32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Property for Rotation {}
 
 /// The model name shall to the extent possible describe the sensor. For
@@ -1275,6 +1326,21 @@ impl ControlEntry for UnitCellSize {
     const ID: u32 = PropertyId::UnitCellSize as _;
 }
 
+impl FixedSizeControlEntry for UnitCellSize {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_SIZE;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = Size;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Property for UnitCellSize {}
 
 /// The camera sensor pixel array readable area vertical and horizontal
@@ -1387,6 +1453,21 @@ impl ControlEntry for PixelArraySize {
     const ID: u32 = PropertyId::PixelArraySize as _;
 }
 
+impl FixedSizeControlEntry for PixelArraySize {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_SIZE;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = Size;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Property for PixelArraySize {}
 
 /// The pixel array region(s) which contain optical black pixels
@@ -1685,6 +1766,21 @@ impl ControlEntry for ScalerCropMaximum {
     const ID: u32 = PropertyId::ScalerCropMaximum as _;
 }
 
+impl FixedSizeControlEntry for ScalerCropMaximum {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_RECTANGLE;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = Rectangle;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Property for ScalerCropMaximum {}
 
 /// The relative sensitivity of the chosen sensor mode.
@@ -1730,6 +1826,21 @@ impl ControlEntry for SensorSensitivity {
     const ID: u32 = PropertyId::SensorSensitivity as _;
 }
 
+impl FixedSizeControlEntry for SensorSensitivity {
+    const TYPE: u32 = libcamera_control_type::LIBCAMERA_CONTROL_TYPE_FLOAT;
+    const NUM_ELEMENTS: usize = 1;
+    const IS_ARRAY: bool = false;
+    type Repr = f32;
+
+    fn from_repr(repr: Self::Repr) -> Self {
+        Self(repr)
+    }
+
+    fn to_repr(&self) -> Self::Repr {
+        self.0
+    }
+}
+
 impl Property for SensorSensitivity {}
 
 /// The arrangement of color filters on sensor; represents the colors in the
@@ -14,7 +14,8 @@ impl From<libcamera_point_t> for Point {
 }
 
 /// Represents `libcamera::Size`
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+#[repr(C)]
 pub struct Size {
     pub width: u32,
     pub height: u32,
@@ -70,7 +71,8 @@ impl From<SizeRange> for libcamera_size_range_t {
 }
 
 /// Represents `libcamera::Rectangle`
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+#[repr(C)]
 pub struct Rectangle {
     pub x: i32,
     pub y: i32,
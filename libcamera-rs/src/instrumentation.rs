@@ -0,0 +1,138 @@
+//! Hot-path latency instrumentation, enabled with the `instrumentation` cargo feature.
+//!
+//! Records per-stage capture latencies into lock-free log2-bucket histograms:
+//!
+//! * queue call duration — time spent inside the libcamera `queueRequest` FFI call,
+//! * queue to completion — from [ActiveCamera::queue_request()](crate::camera::ActiveCamera::queue_request)
+//!   until the completion callback fires in the libcamera thread,
+//! * sensor to completion — from the kernel buffer timestamp
+//!   ([SensorTimestamp](crate::controls::SensorTimestamp)) until completion delivery,
+//!   isolating the post-capture processing and delivery overhead.
+//!
+//! Recording is a single atomic increment per sample and happens entirely inside the existing
+//! queue/completion paths; with the feature disabled none of this module is compiled and the hot
+//! path is untouched.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use crate::{controls, request::Request};
+
+pub use crate::utils::monotonic_ns;
+
+/// Lock-free latency histogram with logarithmic buckets.
+///
+/// Bucket `i` counts samples in `[2^(i-1), 2^i)` nanoseconds, giving full range coverage at
+/// sub-10% resolution with a fixed footprint. Recording is one relaxed atomic increment, so
+/// histograms can be updated concurrently from the libcamera thread and caller threads.
+pub struct LatencyHistogram {
+    buckets: [AtomicU64; Self::BUCKETS],
+}
+
+impl LatencyHistogram {
+    /// 2^47 ns is about 39 hours, enough for any latency worth recording.
+    const BUCKETS: usize = 48;
+
+    pub(crate) fn record(&self, ns: u64) {
+        let idx = ((u64::BITS - ns.leading_zeros()) as usize).min(Self::BUCKETS - 1);
+        self.buckets[idx].fetch_add(1, Ordering::Relaxed);
+    }
+
+    /// Total number of recorded samples.
+    pub fn count(&self) -> u64 {
+        self.buckets.iter().map(|b| b.load(Ordering::Relaxed)).sum()
+    }
+
+    /// Upper bound in nanoseconds of the bucket containing the given quantile (0.0 to 1.0).
+    ///
+    /// Returns `None` if the histogram is empty.
+    pub fn quantile(&self, q: f64) -> Option<u64> {
+        let total = self.count();
+        if total == 0 {
+            return None;
+        }
+
+        let target = ((total as f64) * q.clamp(0.0, 1.0)).ceil() as u64;
+        let mut seen = 0;
+        for (i, bucket) in self.buckets.iter().enumerate() {
+            seen += bucket.load(Ordering::Relaxed);
+            if seen >= target {
+                return Some(if i == 0 { 0 } else { 1u64 << i });
+            }
+        }
+        Some(1u64 << (Self::BUCKETS - 1))
+    }
+}
+
+impl Default for LatencyHistogram {
+    fn default() -> Self {
+        Self {
+            buckets: core::array::from_fn(|_| AtomicU64::new(0)),
+        }
+    }
+}
+
+impl core::fmt::Debug for LatencyHistogram {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("LatencyHistogram")
+            .field("count", &self.count())
+            .field("p50_ns", &self.quantile(0.5))
+            .field("p99_ns", &self.quantile(0.99))
+            .field("max_ns", &self.quantile(1.0))
+            .finish()
+    }
+}
+
+/// Per-camera capture latency metrics.
+///
+/// Obtained from [ActiveCamera::metrics()](crate::camera::ActiveCamera::metrics).
+#[derive(Debug, Default)]
+pub struct CaptureMetrics {
+    queue_call: LatencyHistogram,
+    queue_to_complete: LatencyHistogram,
+    sensor_to_complete: LatencyHistogram,
+    requests_queued: AtomicU64,
+    requests_completed: AtomicU64,
+}
+
+impl CaptureMetrics {
+    /// Duration of the libcamera `queueRequest` call itself (queue-to-kernel handoff).
+    pub fn queue_call(&self) -> &LatencyHistogram {
+        &self.queue_call
+    }
+
+    /// Latency from request queueing until completion callback delivery.
+    pub fn queue_to_complete(&self) -> &LatencyHistogram {
+        &self.queue_to_complete
+    }
+
+    /// Latency from the sensor buffer timestamp until completion callback delivery.
+    pub fn sensor_to_complete(&self) -> &LatencyHistogram {
+        &self.sensor_to_complete
+    }
+
+    /// Total number of requests queued, including requeues.
+    pub fn requests_queued(&self) -> u64 {
+        self.requests_queued.load(Ordering::Relaxed)
+    }
+
+    /// Total number of completed (non-cancelled) requests delivered.
+    pub fn requests_completed(&self) -> u64 {
+        self.requests_completed.load(Ordering::Relaxed)
+    }
+
+    pub(crate) fn record_queued(&self, call_duration_ns: u64) {
+        self.requests_queued.fetch_add(1, Ordering::Relaxed);
+        self.queue_call.record(call_duration_ns);
+    }
+
+    pub(crate) fn record_completed(&self, req: &Request) {
+        let now = monotonic_ns();
+
+        self.requests_completed.fetch_add(1, Ordering::Relaxed);
+        self.queue_to_complete.record(now.saturating_sub(req.queued_at));
+
+        if let Ok(ts) = req.metadata().get::<controls::SensorTimestamp>() {
+            self.sensor_to_complete.record(now.saturating_sub(ts.0 as u64));
+        }
+    }
+}
@@ -1,14 +1,24 @@
 pub mod camera;
 pub mod camera_manager;
+pub mod capture_loop;
+pub mod completion;
 pub mod control;
 pub mod control_value;
+pub mod conversion;
+pub mod dmabuf;
+pub mod frame_broker;
+pub mod frame_writer;
 pub mod framebuffer;
 pub mod framebuffer_allocator;
 pub mod framebuffer_map;
 pub mod geometry;
+#[cfg(feature = "instrumentation")]
+pub mod instrumentation;
 pub mod pixel_format;
+pub mod processing_pool;
 pub mod request;
 pub mod stream;
+pub mod synced_capture;
 pub mod utils;
 
 mod generated;
@@ -54,6 +54,13 @@ impl PartialEq for PixelFormat {
 
 impl Eq for PixelFormat {}
 
+impl core::hash::Hash for PixelFormat {
+    fn hash<H: core::hash::Hasher>(&self, state: &mut H) {
+        self.0.fourcc.hash(state);
+        self.0.modifier.hash(state);
+    }
+}
+
 impl core::fmt::Debug for PixelFormat {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         f.write_str(&self.to_string())
@@ -0,0 +1,281 @@
+use std::{
+    collections::VecDeque,
+    sync::{
+        atomic::{AtomicBool, AtomicU64, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    thread::JoinHandle,
+};
+
+use crate::{
+    camera::{ActiveCamera, Requeuer},
+    completion::CompletionRing,
+    request::{Request, RequestStatus, ReuseFlag},
+};
+
+/// Work-stealing thread pool for post-processing completed [Request]s.
+///
+/// The callback set by [ActiveCamera::on_request_completed()] runs in the libcamera camera
+/// manager thread, where any real processing stalls the pipeline handler for every camera
+/// sharing the manager. A per-camera channel+thread avoids that but load-balances badly across
+/// streams of different sizes. This pool fans completions of any number of attached cameras out
+/// to a fixed set of worker threads instead: the libcamera-thread handoff is a single lock-free
+/// [CompletionRing] push per completion, workers drain the rings into per-worker queues and
+/// steal from each other when their own work runs out, and finished requests are requeued
+/// through the camera's internal requeue handle without caller involvement.
+///
+/// The pool owns the attached cameras, which keeps the requeue handles held by the workers valid
+/// for the pool's entire lifetime. Access them through [Self::camera_mut()] to configure, start
+/// and queue the initial requests.
+pub struct ProcessingPool<'d> {
+    cameras: Vec<ActiveCamera<'d>>,
+    shared: Arc<PoolShared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+/// Per-camera processing job, shared by all workers.
+type Job = Arc<dyn Fn(&mut Request) + Send + Sync + 'static>;
+
+/// Completion source of one attached camera.
+struct CameraSlot {
+    /// Filled by the camera's completion callback in the libcamera thread.
+    ring: Arc<CompletionRing>,
+    /// Guards the consumer side of `ring`, try-locked so exactly one worker drains at a time.
+    gate: Mutex<()>,
+    requeuer: Requeuer,
+    job: Job,
+}
+
+struct PoolShared {
+    /// Attached cameras; only locked briefly for a snapshot, never while processing.
+    cameras: Mutex<Vec<Arc<CameraSlot>>>,
+    /// Per-worker queues of (camera index, request) drained out of the rings. A worker pops its
+    /// own queue from the front, thieves split off the back half.
+    locals: Vec<Mutex<VecDeque<(usize, Request)>>>,
+    /// Count of wakeups not yet consumed by a rescan; the associated mutex is held only for the
+    /// counter bump, so the libcamera thread never blocks on a busy worker.
+    pending: Mutex<usize>,
+    available: Condvar,
+    shutdown: AtomicBool,
+    /// Number of requests processed by a worker other than the one that drained them.
+    stolen: AtomicU64,
+}
+
+impl<'d> ProcessingPool<'d> {
+    /// Creates a pool with a given number of worker threads.
+    pub fn new(workers: usize) -> Self {
+        Self::spawn(workers, false)
+    }
+
+    /// Creates a pool whose worker threads are pinned round-robin to CPU cores.
+    ///
+    /// Pinning keeps per-frame working sets cache-resident across frames. It is best effort:
+    /// when the affinity call fails (e.g. in a restricted cgroup), workers run unpinned.
+    pub fn new_pinned(workers: usize) -> Self {
+        Self::spawn(workers, true)
+    }
+
+    fn spawn(workers: usize, pin: bool) -> Self {
+        let shared = Arc::new(PoolShared {
+            cameras: Mutex::new(Vec::new()),
+            locals: (0..workers).map(|_| Mutex::new(VecDeque::new())).collect(),
+            pending: Mutex::new(0),
+            available: Condvar::new(),
+            shutdown: AtomicBool::new(false),
+            stolen: AtomicU64::new(0),
+        });
+
+        let cores = std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1);
+        let workers = (0..workers)
+            .map(|index| {
+                let shared = shared.clone();
+                std::thread::spawn(move || {
+                    if pin {
+                        set_affinity(index % cores);
+                    }
+                    worker_loop(&shared, index);
+                })
+            })
+            .collect();
+
+        Self {
+            cameras: Vec::new(),
+            shared,
+            workers,
+        }
+    }
+
+    /// Attaches a camera, returning its pool index.
+    ///
+    /// `job` runs on a worker thread for every completed request of this camera. When it
+    /// returns, the request is requeued with reused buffers; cancelled requests (capture
+    /// stopped) are dropped without being processed.
+    pub fn attach(
+        &mut self,
+        mut camera: ActiveCamera<'d>,
+        job: impl Fn(&mut Request) + Send + Sync + 'static,
+    ) -> usize {
+        let slot = Arc::new(CameraSlot {
+            ring: Arc::new(CompletionRing::default()),
+            gate: Mutex::new(()),
+            requeuer: camera.requeuer(),
+            job: Arc::new(job),
+        });
+
+        let shared = self.shared.clone();
+        let ring = slot.ring.clone();
+        camera.on_request_completed(move |req| {
+            ring.push(req);
+            *shared.pending.lock().unwrap() += 1;
+            shared.available.notify_one();
+        });
+
+        self.shared.cameras.lock().unwrap().push(slot);
+        self.cameras.push(camera);
+        self.cameras.len() - 1
+    }
+
+    /// Number of attached cameras.
+    pub fn len(&self) -> usize {
+        self.cameras.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.cameras.is_empty()
+    }
+
+    /// Camera at a given pool index.
+    pub fn camera(&self, index: usize) -> Option<&ActiveCamera<'d>> {
+        self.cameras.get(index)
+    }
+
+    /// Mutable camera access, e.g. to start capture and queue the initial requests.
+    pub fn camera_mut(&mut self, index: usize) -> Option<&mut ActiveCamera<'d>> {
+        self.cameras.get_mut(index)
+    }
+
+    /// Number of requests processed by a worker other than the one that drained them.
+    ///
+    /// A persistently high rate relative to the frame rate indicates that per-camera load is
+    /// uneven and the pool is spending time migrating work between cores.
+    pub fn stolen_jobs(&self) -> u64 {
+        self.shared.stolen.load(Ordering::Relaxed)
+    }
+}
+
+impl<'d> Drop for ProcessingPool<'d> {
+    fn drop(&mut self) {
+        {
+            let _pending = self.shared.pending.lock().unwrap();
+            self.shared.shutdown.store(true, Ordering::Release);
+            self.shared.available.notify_all();
+        }
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+        // The cameras drop after the workers have exited, so the requeue handles held in
+        // PoolShared are never used past their camera's lifetime. Unprocessed requests left in
+        // rings and local queues are dropped with PoolShared.
+    }
+}
+
+fn worker_loop(shared: &PoolShared, worker: usize) {
+    loop {
+        if let Some((slot, req)) = find_work(shared, worker) {
+            run_job(&slot, req);
+            continue;
+        }
+
+        let mut pending = shared.pending.lock().unwrap();
+        while *pending == 0 {
+            if shared.shutdown.load(Ordering::Acquire) {
+                return;
+            }
+            pending = shared.available.wait(pending).unwrap();
+        }
+        // Consume all outstanding wakeups at once, the full rescan below covers them.
+        *pending = 0;
+    }
+}
+
+/// Finds the next request for a worker: its own queue first, then the camera rings, then the
+/// back half of a sibling's queue.
+fn find_work(shared: &PoolShared, worker: usize) -> Option<(Arc<CameraSlot>, Request)> {
+    let slots: Vec<Arc<CameraSlot>> = shared.cameras.lock().unwrap().clone();
+
+    if let Some((index, req)) = shared.locals[worker].lock().unwrap().pop_front() {
+        return Some((slots[index].clone(), req));
+    }
+
+    for (index, slot) in slots.iter().enumerate() {
+        let Ok(_gate) = slot.gate.try_lock() else {
+            continue;
+        };
+
+        let Some(first) = slot.ring.pop() else {
+            continue;
+        };
+
+        // Drain the rest of the ring into the local queue, where idle workers can steal it.
+        let mut extra = 0;
+        {
+            let mut local = shared.locals[worker].lock().unwrap();
+            while let Some(req) = slot.ring.pop() {
+                local.push_back((index, req));
+                extra += 1;
+            }
+        }
+        if extra > 0 {
+            *shared.pending.lock().unwrap() += extra;
+            shared.available.notify_all();
+        }
+
+        return Some((slot.clone(), first));
+    }
+
+    for victim in (0..shared.locals.len()).filter(|&v| v != worker) {
+        let Ok(mut queue) = shared.locals[victim].try_lock() else {
+            continue;
+        };
+        if queue.is_empty() {
+            continue;
+        }
+
+        // Take the newer half, the victim keeps draining its older frames in order.
+        let mut stolen = queue.split_off(queue.len() / 2);
+        drop(queue);
+
+        shared.stolen.fetch_add(stolen.len() as u64, Ordering::Relaxed);
+        let (index, req) = stolen.pop_front().unwrap();
+        if !stolen.is_empty() {
+            shared.locals[worker].lock().unwrap().extend(stolen);
+        }
+        return Some((slots[index].clone(), req));
+    }
+
+    None
+}
+
+fn run_job(slot: &CameraSlot, mut req: Request) {
+    if req.status() == RequestStatus::Cancelled {
+        // Capture was stopped; the request is dropped and its in-flight slot freed.
+        return;
+    }
+
+    (slot.job)(&mut req);
+
+    req.reuse(ReuseFlag::ReuseBuffers);
+    // Queueing can only fail when capture is being stopped, in which case the request arrives
+    // again through the cancelled path above.
+    let _ = slot.requeuer.queue(req);
+}
+
+/// Pins the calling thread to a single CPU core, best effort.
+fn set_affinity(core: usize) {
+    unsafe {
+        let mut set: libc::cpu_set_t = core::mem::zeroed();
+        libc::CPU_ZERO(&mut set);
+        libc::CPU_SET(core % libc::CPU_SETSIZE as usize, &mut set);
+        libc::sched_setaffinity(0, core::mem::size_of::<libc::cpu_set_t>(), &set);
+    }
+}
@@ -2,7 +2,9 @@ use std::{any::Any, collections::HashMap, io, ptr::NonNull};
 
 use libcamera_sys::*;
 
-use crate::{control::ControlListRef, framebuffer::AsFrameBuffer, stream::Stream, utils::Immutable};
+use crate::{
+    camera::RequestSlotHandle, control::ControlListRef, framebuffer::AsFrameBuffer, stream::Stream, utils::Immutable,
+};
 
 /// Status of [Request]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -15,6 +17,24 @@ pub enum RequestStatus {
     Cancelled,
 }
 
+/// Flags for [Request::reuse()]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ReuseFlag {
+    /// Reuse the request fully, detaching all previously attached framebuffers.
+    Default,
+    /// Reuse the request and keep framebuffers attached, so only controls have to be set before requeueing.
+    ReuseBuffers,
+}
+
+impl From<ReuseFlag> for libcamera_request_reuse_flag_t {
+    fn from(val: ReuseFlag) -> Self {
+        match val {
+            ReuseFlag::Default => libcamera_request_reuse_flag::LIBCAMERA_REQUEST_REUSE_DEFAULT,
+            ReuseFlag::ReuseBuffers => libcamera_request_reuse_flag::LIBCAMERA_REQUEST_REUSE_BUFFERS,
+        }
+    }
+}
+
 impl TryFrom<libcamera_request_status_t> for RequestStatus {
     type Error = String;
 
@@ -36,14 +56,30 @@ impl TryFrom<libcamera_request_status_t> for RequestStatus {
 /// and can (should) be reused by calling [ActiveCamera::queue_request()](crate::camera::ActiveCamera::queue_request) again.
 pub struct Request {
     pub(crate) ptr: NonNull<libcamera_request_t>,
+    /// Slot that dispatches completions of this request, see
+    /// [RequestSlots](crate::camera::RequestSlots). Its index is the libcamera cookie.
+    pub(crate) slot: RequestSlotHandle,
+    /// User-provided identifier returned by [Self::cookie()]. The libcamera cookie is occupied
+    /// by the slot index, so the user one is kept here.
+    cookie: u64,
     buffers: HashMap<Stream, Box<dyn Any + 'static>>,
+    /// Arbitrary per-request context, see [Self::set_user_data()].
+    user_data: Option<Box<dyn Any + Send + 'static>>,
+    /// `CLOCK_MONOTONIC` timestamp of the last queue_request() call, used for latency metrics.
+    #[cfg(feature = "instrumentation")]
+    pub(crate) queued_at: u64,
 }
 
 impl Request {
-    pub(crate) unsafe fn from_ptr(ptr: NonNull<libcamera_request_t>) -> Self {
+    pub(crate) unsafe fn from_ptr(ptr: NonNull<libcamera_request_t>, cookie: u64, slot: RequestSlotHandle) -> Self {
         Self {
             ptr,
+            slot,
+            cookie,
             buffers: Default::default(),
+            user_data: None,
+            #[cfg(feature = "instrumentation")]
+            queued_at: 0,
         }
     }
 
@@ -109,13 +145,61 @@ impl Request {
     ///
     /// Returns zero if cookie was not provided.
     pub fn cookie(&self) -> u64 {
-        unsafe { libcamera_request_cookie(self.ptr.as_ptr()) }
+        self.cookie
+    }
+
+    /// Attaches arbitrary context to the request, replacing any previous one.
+    ///
+    /// The context travels with the request through the queue/complete round-trip, so a
+    /// completion handler can recover e.g. its per-frame deadline or consumer tag directly from
+    /// the [Request] instead of keeping a cookie-keyed map on the side.
+    pub fn set_user_data<T: Any + Send>(&mut self, data: T) {
+        self.user_data = Some(Box::new(data));
+    }
+
+    /// Returns a reference to the context attached with [Self::set_user_data()].
+    ///
+    /// `T` must be equal to the type used in [Self::set_user_data()], otherwise this will return None.
+    pub fn user_data<T: Any + Send>(&self) -> Option<&T> {
+        self.user_data.as_ref().and_then(|d| d.downcast_ref())
+    }
+
+    /// Returns a mutable reference to the context attached with [Self::set_user_data()].
+    ///
+    /// `T` must be equal to the type used in [Self::set_user_data()], otherwise this will return None.
+    pub fn user_data_mut<T: Any + Send>(&mut self) -> Option<&mut T> {
+        self.user_data.as_mut().and_then(|d| d.downcast_mut())
+    }
+
+    /// Detaches and returns the context attached with [Self::set_user_data()].
+    ///
+    /// `T` must be equal to the type used in [Self::set_user_data()], otherwise this will return
+    /// None and the context stays attached.
+    pub fn take_user_data<T: Any + Send>(&mut self) -> Option<T> {
+        if self.user_data.as_ref()?.is::<T>() {
+            self.user_data.take()?.downcast().ok().map(|d| *d)
+        } else {
+            None
+        }
     }
 
     /// Capture request status
     pub fn status(&self) -> RequestStatus {
         RequestStatus::try_from(unsafe { libcamera_request_status(self.ptr.as_ptr()) }).unwrap()
     }
+
+    /// Resets the request for reuse, avoiding a destroy and create round-trip for every capture.
+    ///
+    /// With [ReuseFlag::ReuseBuffers] framebuffers attached by [Self::add_buffer()] stay attached,
+    /// so a completed request can be requeued by [ActiveCamera::queue_request()](crate::camera::ActiveCamera::queue_request)
+    /// without any per-frame allocations. With [ReuseFlag::Default] all buffers are detached and
+    /// have to be re-attached before requeueing.
+    pub fn reuse(&mut self, flags: ReuseFlag) {
+        unsafe { libcamera_request_reuse(self.ptr.as_ptr(), flags.into()) };
+        if flags != ReuseFlag::ReuseBuffers {
+            self.buffers.clear();
+        }
+    }
 }
 
 impl core::fmt::Debug for Request {
@@ -135,3 +219,45 @@ impl Drop for Request {
 }
 
 unsafe impl Send for Request {}
+
+/// A pool of reusable capture requests.
+///
+/// Requests are created once with [ActiveCamera::create_request()](crate::camera::ActiveCamera::create_request),
+/// initialized with framebuffers and added to the pool. Completed requests are returned with
+/// [Self::recycle()], which calls [Request::reuse()] with [ReuseFlag::ReuseBuffers] so that
+/// steady-state capture performs no request or buffer allocations at all.
+pub struct RequestPool {
+    free: Vec<Request>,
+}
+
+impl RequestPool {
+    /// Creates a pool from pre-initialized requests (usually one per allocated framebuffer).
+    pub fn new(requests: impl IntoIterator<Item = Request>) -> Self {
+        Self {
+            free: requests.into_iter().collect(),
+        }
+    }
+
+    /// Takes a request out of the pool, if any are available.
+    pub fn get(&mut self) -> Option<Request> {
+        self.free.pop()
+    }
+
+    /// Returns a completed request back into the pool.
+    ///
+    /// The request is reset with [ReuseFlag::ReuseBuffers], keeping its framebuffers attached.
+    pub fn recycle(&mut self, mut request: Request) {
+        request.reuse(ReuseFlag::ReuseBuffers);
+        self.free.push(request);
+    }
+
+    /// Number of requests currently available in the pool.
+    pub fn len(&self) -> usize {
+        self.free.len()
+    }
+
+    /// Returns true if there are no requests available in the pool.
+    pub fn is_empty(&self) -> bool {
+        self.free.is_empty()
+    }
+}
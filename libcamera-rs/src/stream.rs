@@ -11,7 +11,7 @@ use crate::{
 /// Stream role hint for generating configuration.
 ///
 /// Used in [Camera::generate_configuration()](crate::camera::Camera::generate_configuration).
-#[derive(Debug, Clone, Copy)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub enum StreamRole {
     Raw,
     StillCapture,
@@ -84,6 +84,116 @@ impl<'d> StreamFormatsRef<'d> {
     }
 }
 
+/// Flat dump of all stream formats, exported in a single FFI crossing.
+///
+/// Enumerating formats through [StreamFormatsRef::pixel_formats()] and [StreamFormatsRef::sizes()]
+/// heap-allocates a copied vector on the C++ side per call, once per pixel format.
+/// [Self::capture()] instead walks the formats once and writes all (pixel format, sizes, size
+/// range) tuples into two reusable buffers. Buffers retain their capacity across captures, so
+/// re-enumeration is allocation-free.
+#[derive(Default)]
+pub struct StreamFormatsSnapshot {
+    entries: Vec<libcamera_stream_formats_dump_entry_t>,
+    sizes: Vec<libcamera_size_t>,
+    /// Number of valid entries after the last capture.
+    len: usize,
+}
+
+impl StreamFormatsSnapshot {
+    pub fn new() -> Self {
+        Default::default()
+    }
+
+    /// Exports all formats into the snapshot, replacing previous contents.
+    pub fn capture(&mut self, formats: &StreamFormatsRef) {
+        loop {
+            let mut sizes_used = 0usize;
+            let count = unsafe {
+                libcamera_stream_formats_dump(
+                    formats.ptr.as_ptr(),
+                    self.entries.as_mut_ptr(),
+                    self.entries.len() as _,
+                    self.sizes.as_mut_ptr(),
+                    self.sizes.len() as _,
+                    &mut sizes_used,
+                )
+            } as usize;
+
+            if count <= self.entries.len() && sizes_used <= self.sizes.len() {
+                self.len = count;
+                return;
+            }
+
+            // Buffers too small (first capture), grow and retry.
+            self.entries.resize_with(count, || unsafe { core::mem::zeroed() });
+            self.sizes.resize_with(sizes_used, || unsafe { core::mem::zeroed() });
+        }
+    }
+
+    /// Number of pixel formats in the snapshot.
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns the format entry at a given index.
+    pub fn get(&self, index: usize) -> Option<StreamFormatEntry<'_>> {
+        if index >= self.len {
+            return None;
+        }
+
+        let entry = &self.entries[index];
+        Some(StreamFormatEntry {
+            entry,
+            sizes: &self.sizes[entry.sizes_offset as usize..(entry.sizes_offset + entry.num_sizes) as usize],
+        })
+    }
+
+    /// Iterates over format entries without crossing FFI.
+    pub fn iter(&self) -> impl Iterator<Item = StreamFormatEntry<'_>> {
+        (0..self.len).map(|i| self.get(i).unwrap())
+    }
+}
+
+/// A single pixel format with its supported sizes, borrowed from a [StreamFormatsSnapshot].
+pub struct StreamFormatEntry<'d> {
+    entry: &'d libcamera_stream_formats_dump_entry_t,
+    sizes: &'d [libcamera_size_t],
+}
+
+impl<'d> StreamFormatEntry<'d> {
+    pub fn pixel_format(&self) -> PixelFormat {
+        PixelFormat(self.entry.pixel_format)
+    }
+
+    /// Range of supported stream sizes for this pixel format.
+    pub fn range(&self) -> SizeRange {
+        SizeRange::from(self.entry.range)
+    }
+
+    pub fn num_sizes(&self) -> usize {
+        self.sizes.len()
+    }
+
+    /// Iterates over the supported stream [Size]s for this pixel format.
+    pub fn sizes(&self) -> impl Iterator<Item = Size> + 'd {
+        self.sizes.iter().map(|s| Size::from(*s))
+    }
+}
+
+impl<'d> core::fmt::Debug for StreamFormatEntry<'d> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("StreamFormatEntry")
+            .field("pixel_format", &self.pixel_format())
+            .field("sizes", &self.sizes().collect::<Vec<_>>())
+            .field("range", &self.range())
+            .finish()
+    }
+}
+
 impl<'d> core::fmt::Debug for StreamFormatsRef<'d> {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         let mut map = f.debug_map();
@@ -94,6 +204,19 @@ impl<'d> core::fmt::Debug for StreamFormatsRef<'d> {
     }
 }
 
+/// Plain-data copy of all scalar fields of a [StreamConfigurationRef].
+///
+/// Reading fields through the ref derefs the shared struct once per accessor; a snapshot copies
+/// them all in one go and can then be stored, compared and passed around without a lifetime.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct StreamConfig {
+    pub pixel_format: PixelFormat,
+    pub size: Size,
+    pub stride: u32,
+    pub frame_size: u32,
+    pub buffer_count: u32,
+}
+
 pub struct StreamConfigurationRef<'d> {
     ptr: NonNull<libcamera_stream_configuration_t>,
     _phantom: PhantomData<&'d ()>,
@@ -147,6 +270,28 @@ impl<'d> StreamConfigurationRef<'d> {
         unsafe { self.ptr.as_mut() }.buffer_count = buffer_count;
     }
 
+    /// Reads all scalar configuration fields in one shot.
+    pub fn config(&self) -> StreamConfig {
+        let raw = unsafe { self.ptr.as_ref() };
+        StreamConfig {
+            pixel_format: PixelFormat(raw.pixel_format),
+            size: raw.size.into(),
+            stride: raw.stride,
+            frame_size: raw.frame_size,
+            buffer_count: raw.buffer_count,
+        }
+    }
+
+    /// Writes all scalar configuration fields in one shot.
+    pub fn set_config(&mut self, config: StreamConfig) {
+        let raw = unsafe { self.ptr.as_mut() };
+        raw.pixel_format = config.pixel_format.0;
+        raw.size = config.size.into();
+        raw.stride = config.stride;
+        raw.frame_size = config.frame_size;
+        raw.buffer_count = config.buffer_count;
+    }
+
     /// Returns initialized [Stream] for this configuration.
     ///
     /// Stream is only available once this configuration is applied with [ActiveCamera::configure()](crate::camera::ActiveCamera::configure).
@@ -0,0 +1,470 @@
+use std::{
+    collections::VecDeque,
+    io,
+    sync::{
+        atomic::{AtomicU64, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    time::Duration,
+};
+
+use crate::{
+    camera::ActiveCamera,
+    control::ControlListBatch,
+    controls,
+    framebuffer_allocator::{FrameBuffer, FrameBufferAllocator},
+    framebuffer_map::MemoryMappedFrameBuffer,
+    request::{Request, RequestStatus, ReuseFlag},
+    stream::Stream,
+};
+
+/// Fraction of the measured skew corrected per delivered bundle.
+///
+/// A proportional controller with gain below 1 converges over a few frames without oscillating
+/// around the target when timestamps jitter.
+const SKEW_GAIN: i64 = 4;
+
+/// Correction is clamped to this fraction of the frame duration per frame, so the exposure of a
+/// converging camera is never disturbed visibly.
+const MAX_CORRECTION_DIV: i64 = 16;
+
+/// Synchronized capture scheduler for multiple cameras.
+///
+/// Owns one [ActiveCamera] per sensor, queues their requests back-to-back and delivers completed
+/// frames as pre-matched [FrameBundle]s instead of leaving the consumer to search timestamps
+/// across independently drifting streams.
+///
+/// Synchronization works in two stages:
+///
+/// * Matching: completed frames are held per camera and a bundle is released once every camera
+///   has a frame whose sensor timestamp lies within the tolerance of the newest head-of-line
+///   frame. Frames that can no longer match are requeued immediately (counted in
+///   [Self::dropped_frames()]), so at most a frame per camera is buffered in steady state.
+/// * Convergence: per bundle, each camera's timestamp skew against camera 0 is measured and its
+///   `FrameDurationLimits` control is adjusted proportionally on the requeue path, so free
+///   running sensors drift toward simultaneous exposure instead of keeping their start-up offset.
+///
+/// Buffer allocation, mapping and requeueing follow [CaptureLoop](crate::capture_loop::CaptureLoop):
+/// all buffers are allocated and mapped up front and steady-state capture performs no allocations.
+pub struct SyncedCaptureGroup<'d> {
+    cameras: Vec<SyncedCamera<'d>>,
+    shared: Arc<SyncShared>,
+    /// Matching tolerance override, see [Self::set_tolerance()].
+    tolerance_ns: Option<u64>,
+}
+
+struct SyncedCamera<'d> {
+    camera: ActiveCamera<'d>,
+    stream: Stream,
+    /// Reusable batch for writing duration corrections into requeued requests.
+    batch: Mutex<ControlListBatch>,
+    /// Frame duration currently requested from this camera in ns. Zero until the control loop
+    /// has engaged. Written during bundle assembly, read on the requeue path.
+    target_duration_ns: AtomicU64,
+    /// Keeps buffer mappings alive; buffers themselves are owned by the attached requests.
+    _alloc: FrameBufferAllocator,
+}
+
+struct SyncShared {
+    queue: Mutex<SyncQueue>,
+    /// Notified when a completed frame is pushed for matching.
+    available: Condvar,
+}
+
+#[derive(Default)]
+struct SyncQueue {
+    /// Completed requests per camera awaiting matching, oldest first, with sensor timestamps.
+    completed: Vec<VecDeque<(u64, Request)>>,
+    /// Requests per camera that are currently not in flight (initial state, or capture stopped).
+    parked: Vec<Vec<Request>>,
+    /// Sensor timestamp of camera 0 in the previously delivered bundle, for measuring the frame
+    /// duration.
+    last_ref_ts: u64,
+    /// Frame duration in ns: configured via start() or measured from camera 0 deltas.
+    frame_duration_ns: u64,
+    /// Number of frames requeued without being delivered because they could not be matched.
+    dropped: u64,
+}
+
+impl<'d> SyncedCaptureGroup<'d> {
+    pub fn new() -> Self {
+        Self {
+            cameras: Vec::new(),
+            shared: Arc::new(SyncShared {
+                queue: Mutex::new(SyncQueue::default()),
+                available: Condvar::new(),
+            }),
+            tolerance_ns: None,
+        }
+    }
+
+    /// Adds a configured camera to the group, returning its index within delivered bundles.
+    ///
+    /// Camera 0 is the synchronization reference that all other cameras converge towards.
+    /// Allocates and memory maps all framebuffers of the stream and attaches each to its own
+    /// request, like [CaptureLoop](crate::capture_loop::CaptureLoop). Cameras must be added
+    /// before [Self::start()].
+    pub fn add_camera(&mut self, mut camera: ActiveCamera<'d>, stream: Stream) -> io::Result<usize> {
+        let index = self.cameras.len();
+
+        let mut alloc = FrameBufferAllocator::new(&camera);
+        let buffers = alloc.alloc(&stream)?;
+
+        let mut parked = Vec::with_capacity(buffers.len());
+        for buffer in buffers {
+            let buffer = MemoryMappedFrameBuffer::new(buffer)?;
+            let mut req = camera.create_request(None).ok_or(io::ErrorKind::OutOfMemory)?;
+            req.add_buffer(&stream, buffer)?;
+            parked.push(req);
+        }
+
+        {
+            let mut queue = self.shared.queue.lock().unwrap();
+            queue.completed.push(VecDeque::with_capacity(parked.len()));
+            queue.parked.push(parked);
+        }
+
+        let cb_shared = self.shared.clone();
+        camera.on_request_completed(move |req| {
+            let mut queue = cb_shared.queue.lock().unwrap();
+            if req.status() == RequestStatus::Cancelled {
+                // Capture was stopped, keep the request for the next start().
+                queue.parked[index].push(req);
+                return;
+            }
+
+            let ts = sensor_timestamp(&req);
+            queue.completed[index].push_back((ts, req));
+            drop(queue);
+
+            cb_shared.available.notify_one();
+        });
+
+        self.cameras.push(SyncedCamera {
+            camera,
+            stream,
+            batch: Mutex::new(ControlListBatch::new()),
+            target_duration_ns: AtomicU64::new(0),
+            _alloc: alloc,
+        });
+
+        Ok(index)
+    }
+
+    /// Number of cameras in the group.
+    pub fn len(&self) -> usize {
+        self.cameras.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.cameras.is_empty()
+    }
+
+    /// Camera at a given bundle index.
+    pub fn camera(&self, index: usize) -> Option<&ActiveCamera<'d>> {
+        self.cameras.get(index).map(|c| &c.camera)
+    }
+
+    /// Overrides the matching tolerance.
+    ///
+    /// Frames whose sensor timestamps differ by more than this are never delivered in the same
+    /// bundle. Defaults to half the frame duration, i.e. every frame matches exactly one frame
+    /// of every other camera.
+    pub fn set_tolerance(&mut self, tolerance: Duration) {
+        self.tolerance_ns = Some(tolerance.as_nanos() as u64);
+    }
+
+    /// Starts capture on all cameras and queues their requests back-to-back.
+    ///
+    /// Initial requests are queued interleaved (first request of every camera in direct
+    /// succession and so on), which minimizes the start-up offset that the control loop has to
+    /// work off.
+    ///
+    /// `frame_duration` seeds the convergence loop and is applied to all cameras; when [None],
+    /// the duration is measured from the deltas of camera 0 and sensors start free running.
+    pub fn start(&mut self, frame_duration: Option<Duration>) -> io::Result<()> {
+        let duration_ns = frame_duration.map(|d| d.as_nanos() as u64).unwrap_or(0);
+
+        for cam in &self.cameras {
+            cam.target_duration_ns.store(duration_ns, Ordering::Relaxed);
+        }
+
+        for cam in &mut self.cameras {
+            cam.camera.start(None)?;
+        }
+
+        let mut parked: Vec<Vec<Request>> = {
+            let mut queue = self.shared.queue.lock().unwrap();
+            queue.frame_duration_ns = duration_ns;
+            queue.last_ref_ts = 0;
+            queue.parked.iter_mut().map(core::mem::take).collect()
+        };
+
+        // Queue round-robin so the initial exposures of all cameras start as close to each other
+        // as the queueing FFI cost allows.
+        while parked.iter().any(|p| !p.is_empty()) {
+            for (index, reqs) in parked.iter_mut().enumerate() {
+                if let Some(req) = reqs.pop() {
+                    self.requeue(index, req)?;
+                }
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Stops capture on all cameras.
+    ///
+    /// In-flight requests are cancelled by libcamera and returned to the idle pool, ready for
+    /// the next [Self::start()].
+    pub fn stop(&mut self) -> io::Result<()> {
+        for cam in &mut self.cameras {
+            cam.camera.stop()?;
+        }
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        for index in 0..queue.completed.len() {
+            while let Some((_, req)) = queue.completed[index].pop_front() {
+                queue.parked[index].push(req);
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Returns a matched frame bundle, if one can be assembled, without blocking.
+    pub fn try_next_bundle(&self) -> Option<FrameBundle<'_, 'd>> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        let (bundle, unmatched) = self.take_bundle(&mut queue);
+        drop(queue);
+        self.requeue_unmatched(unmatched);
+        bundle
+    }
+
+    /// Blocks until a matched frame bundle is available.
+    pub fn next_bundle(&self) -> FrameBundle<'_, 'd> {
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            let (bundle, unmatched) = self.take_bundle(&mut queue);
+            if bundle.is_some() || !unmatched.is_empty() {
+                drop(queue);
+                self.requeue_unmatched(unmatched);
+                if let Some(bundle) = bundle {
+                    return bundle;
+                }
+                queue = self.shared.queue.lock().unwrap();
+                continue;
+            }
+            queue = self.shared.available.wait(queue).unwrap();
+        }
+    }
+
+    /// Blocks until a matched frame bundle is available or the timeout expires.
+    ///
+    /// Fails with [io::ErrorKind::TimedOut] on timeout.
+    pub fn next_bundle_timeout(&self, timeout: Duration) -> io::Result<FrameBundle<'_, 'd>> {
+        let deadline = std::time::Instant::now() + timeout;
+
+        let mut queue = self.shared.queue.lock().unwrap();
+        loop {
+            let (bundle, unmatched) = self.take_bundle(&mut queue);
+            if bundle.is_some() || !unmatched.is_empty() {
+                drop(queue);
+                self.requeue_unmatched(unmatched);
+                if let Some(bundle) = bundle {
+                    return Ok(bundle);
+                }
+                queue = self.shared.queue.lock().unwrap();
+                continue;
+            }
+
+            let remaining = deadline
+                .checked_duration_since(std::time::Instant::now())
+                .ok_or(io::ErrorKind::TimedOut)?;
+            queue = self.shared.available.wait_timeout(queue, remaining).unwrap().0;
+        }
+    }
+
+    /// Number of frames requeued without delivery because they could not be matched.
+    pub fn dropped_frames(&self) -> u64 {
+        self.shared.queue.lock().unwrap().dropped
+    }
+
+    /// Tries to assemble a bundle from the per-camera queues.
+    ///
+    /// Returns the bundle, if complete, and any frames that can no longer match and have to be
+    /// requeued by the caller outside of the queue lock.
+    #[allow(clippy::type_complexity)]
+    fn take_bundle(&self, queue: &mut SyncQueue) -> (Option<FrameBundle<'_, 'd>>, Vec<(usize, Request)>) {
+        let mut unmatched = Vec::new();
+
+        if self.cameras.is_empty() || queue.completed.iter().any(|c| c.is_empty()) {
+            return (None, unmatched);
+        }
+
+        // Match against the newest head-of-line frame: older heads either match it or can never
+        // complete a bundle anymore and are dropped.
+        let ref_ts = queue.completed.iter().map(|c| c.front().unwrap().0).max().unwrap();
+        let tolerance = match self.tolerance_ns {
+            Some(tolerance) => tolerance,
+            // 0.5ms floor until the frame duration has been measured.
+            None => (queue.frame_duration_ns / 2).max(500_000),
+        };
+
+        let mut complete = true;
+        for (index, completed) in queue.completed.iter_mut().enumerate() {
+            while let Some(&(ts, _)) = completed.front() {
+                if ref_ts.abs_diff(ts) <= tolerance {
+                    break;
+                }
+                let (_, req) = completed.pop_front().unwrap();
+                queue.dropped += 1;
+                unmatched.push((index, req));
+            }
+            complete &= !completed.is_empty();
+        }
+
+        if !complete {
+            return (None, unmatched);
+        }
+
+        let bundle: Vec<(u64, Request)> = queue.completed.iter_mut().map(|c| c.pop_front().unwrap()).collect();
+
+        self.update_control_loop(queue, &bundle);
+
+        let ref_ts = bundle[0].0;
+        let mut skews = Vec::with_capacity(bundle.len());
+        let mut frames = Vec::with_capacity(bundle.len());
+        for (ts, req) in bundle {
+            skews.push(ts as i64 - ref_ts as i64);
+            frames.push(Some(req));
+        }
+
+        (
+            Some(FrameBundle {
+                frames,
+                skews,
+                group: self,
+            }),
+            unmatched,
+        )
+    }
+
+    /// Updates the measured frame duration and per-camera duration targets from a new bundle.
+    fn update_control_loop(&self, queue: &mut SyncQueue, frames: &[(u64, Request)]) {
+        let ref_ts = frames[0].0;
+
+        if queue.frame_duration_ns == 0 && queue.last_ref_ts != 0 && ref_ts > queue.last_ref_ts {
+            // No configured duration, adopt the reference camera's measured delta.
+            queue.frame_duration_ns = ref_ts - queue.last_ref_ts;
+        }
+        queue.last_ref_ts = ref_ts;
+
+        let base = queue.frame_duration_ns as i64;
+        if base == 0 {
+            return;
+        }
+
+        for (cam, &(ts, _)) in self.cameras.iter().zip(frames).skip(1) {
+            // Positive skew: this camera exposes later than the reference, shorten its frames so
+            // it catches up. Correct a fraction per frame, clamped to avoid visible exposure
+            // steps.
+            let skew = ts as i64 - ref_ts as i64;
+            let correction = (skew / SKEW_GAIN).clamp(-base / MAX_CORRECTION_DIV, base / MAX_CORRECTION_DIV);
+            cam.target_duration_ns
+                .store((base - correction) as u64, Ordering::Relaxed);
+        }
+    }
+
+    /// Requeues a request on its camera, applying the current duration target.
+    fn requeue(&self, index: usize, mut req: Request) -> io::Result<()> {
+        let cam = &self.cameras[index];
+
+        req.reuse(ReuseFlag::ReuseBuffers);
+
+        let duration = cam.target_duration_ns.load(Ordering::Relaxed);
+        if duration != 0 {
+            let mut batch = cam.batch.lock().unwrap();
+            batch.set(controls::FrameDurationLimits([duration as i64, duration as i64]));
+            batch.apply(&mut req.controls_mut())?;
+        }
+
+        cam.camera.queue_request(req)
+    }
+
+    fn requeue_unmatched(&self, unmatched: Vec<(usize, Request)>) {
+        for (index, req) in unmatched {
+            // Queueing can only fail when capture is being stopped, in which case the request is
+            // recovered through the cancelled path of the completion callback.
+            let _ = self.requeue(index, req);
+        }
+    }
+}
+
+impl<'d> Default for SyncedCaptureGroup<'d> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Reads the sensor timestamp of a completed request, falling back to zero if the pipeline does
+/// not report one (which effectively disables matching for that camera).
+fn sensor_timestamp(req: &Request) -> u64 {
+    req.metadata()
+        .get::<controls::SensorTimestamp>()
+        .map(|ts| ts.0 as u64)
+        .unwrap_or(0)
+}
+
+/// A set of frames, one per camera, captured within the matching tolerance of each other.
+///
+/// Frame `i` belongs to the camera returned from
+/// [SyncedCaptureGroup::add_camera()] with index `i`. Dropping the bundle requeues all requests
+/// with the current duration corrections applied, so the control loop keeps converging without
+/// caller involvement.
+pub struct FrameBundle<'a, 'd> {
+    frames: Vec<Option<Request>>,
+    /// Sensor timestamp skew of each camera against camera 0 in ns.
+    skews: Vec<i64>,
+    group: &'a SyncedCaptureGroup<'d>,
+}
+
+impl<'a, 'd> FrameBundle<'a, 'd> {
+    /// Number of frames in the bundle, equal to the number of cameras in the group.
+    pub fn len(&self) -> usize {
+        self.frames.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.frames.is_empty()
+    }
+
+    /// The completed request of the camera at a given index.
+    pub fn request(&self, index: usize) -> &Request {
+        self.frames[index].as_ref().unwrap()
+    }
+
+    /// Memory mapped framebuffer with the captured frame data of the camera at a given index.
+    pub fn framebuffer(&self, index: usize) -> &MemoryMappedFrameBuffer<FrameBuffer> {
+        self.request(index).buffer(&self.group.cameras[index].stream).unwrap()
+    }
+
+    /// Sensor timestamp skew of the camera at a given index against camera 0 in ns.
+    ///
+    /// Positive values mean the camera exposed later than the reference. Useful for judging
+    /// convergence of the control loop.
+    pub fn skew_ns(&self, index: usize) -> i64 {
+        self.skews[index]
+    }
+}
+
+impl<'a, 'd> Drop for FrameBundle<'a, 'd> {
+    fn drop(&mut self) {
+        for (index, req) in self.frames.iter_mut().enumerate() {
+            if let Some(req) = req.take() {
+                // See requeue_unmatched() for why the error can be ignored.
+                let _ = self.group.requeue(index, req);
+            }
+        }
+    }
+}
@@ -1,4 +1,4 @@
-use std::ops::Deref;
+use std::{cell::UnsafeCell, ops::Deref};
 
 /// Provides only an immutable reference to the contained type T.
 ///
@@ -24,3 +24,117 @@ impl<T: core::fmt::Debug> core::fmt::Debug for Immutable<T> {
         f.debug_tuple("Immutable").field(&self.0).finish()
     }
 }
+
+/// Current `CLOCK_MONOTONIC` time in nanoseconds.
+///
+/// Uses the same clock as libcamera framebuffer timestamps, so sensor timestamps can be
+/// correlated with wall-clock-free host times.
+pub fn monotonic_ns() -> u64 {
+    let mut ts = libc::timespec { tv_sec: 0, tv_nsec: 0 };
+    unsafe { libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts) };
+    ts.tv_sec as u64 * 1_000_000_000 + ts.tv_nsec as u64
+}
+
+/// Initial chunk capacity of [Arena].
+const ARENA_CHUNK_SIZE: usize = 4096;
+
+/// Bump allocator for short-lived plain-old-data slices.
+///
+/// Allocations borrow from the arena and are freed wholesale by [Self::reset()], so a loop that
+/// extracts many values per iteration (e.g. per-frame control metadata, see
+/// [ControlValueRef](crate::control_value::ControlValueRef)) performs no individual heap
+/// allocations in the steady state: after the first iteration the arena retains enough capacity
+/// and every allocation is a pointer bump plus a copy.
+///
+/// Only [Copy] element types are supported, the arena never runs destructors.
+pub struct Arena {
+    /// Raw chunk storage. The used length of each chunk is its `len()`; chunks are never grown
+    /// beyond their initial capacity, so handed-out references stay valid while new allocations
+    /// are made.
+    chunks: UnsafeCell<Vec<Vec<u8>>>,
+}
+
+impl Arena {
+    pub fn new() -> Self {
+        Self::with_capacity(ARENA_CHUNK_SIZE)
+    }
+
+    /// Creates an arena with a given initial capacity in bytes.
+    pub fn with_capacity(bytes: usize) -> Self {
+        Self {
+            chunks: UnsafeCell::new(vec![Vec::with_capacity(bytes)]),
+        }
+    }
+
+    /// Allocates `size` bytes aligned to `align` and returns a pointer to the uninitialized
+    /// storage. `align` must be a power of two.
+    fn alloc_bytes(&self, size: usize, align: usize) -> *mut u8 {
+        // Safety: the mutable borrow is confined to this call; only chunk bookkeeping is
+        // modified, never storage that previous allocations refer to.
+        let chunks = unsafe { &mut *self.chunks.get() };
+
+        let chunk = chunks.last_mut().unwrap();
+        let base = chunk.as_ptr() as usize;
+        let offset = ((base + chunk.len() + align - 1) & !(align - 1)) - base;
+
+        let chunk = if offset + size <= chunk.capacity() {
+            chunk
+        } else {
+            // `align - 1` covers the worst-case alignment padding of the fresh chunk.
+            chunks.push(Vec::with_capacity(ARENA_CHUNK_SIZE.max(size + align - 1)));
+            chunks.last_mut().unwrap()
+        };
+
+        let base = chunk.as_ptr() as usize;
+        let offset = ((base + chunk.len() + align - 1) & !(align - 1)) - base;
+        // The bytes between the old and new length are written by the caller before they become
+        // reachable.
+        unsafe { chunk.set_len(offset + size) };
+        unsafe { chunk.as_mut_ptr().add(offset) }
+    }
+
+    /// Copies a slice into the arena.
+    pub fn alloc_slice<T: Copy>(&self, values: &[T]) -> &[T] {
+        let ptr = self.alloc_bytes(core::mem::size_of_val(values), core::mem::align_of::<T>()) as *mut T;
+        unsafe {
+            core::ptr::copy_nonoverlapping(values.as_ptr(), ptr, values.len());
+            core::slice::from_raw_parts(ptr, values.len())
+        }
+    }
+
+    /// Allocates a slice of `len` elements, initializing each from `f(index)`.
+    pub fn alloc_slice_fill<T: Copy>(&self, len: usize, mut f: impl FnMut(usize) -> T) -> &[T] {
+        let ptr = self.alloc_bytes(len * core::mem::size_of::<T>(), core::mem::align_of::<T>()) as *mut T;
+        unsafe {
+            for i in 0..len {
+                ptr.add(i).write(f(i));
+            }
+            core::slice::from_raw_parts(ptr, len)
+        }
+    }
+
+    /// Copies a string into the arena.
+    pub fn alloc_str(&self, value: &str) -> &str {
+        unsafe { core::str::from_utf8_unchecked(self.alloc_slice(value.as_bytes())) }
+    }
+
+    /// Frees all allocations at once, retaining capacity for reuse.
+    ///
+    /// If allocations spilled into multiple chunks, they are consolidated into a single one, so
+    /// a steady-state workload settles on one chunk that fits an entire iteration.
+    pub fn reset(&mut self) {
+        let chunks = self.chunks.get_mut();
+        if chunks.len() > 1 {
+            let total = chunks.iter().map(|c| c.capacity()).sum();
+            *chunks = vec![Vec::with_capacity(total)];
+        } else {
+            chunks[0].clear();
+        }
+    }
+}
+
+impl Default for Arena {
+    fn default() -> Self {
+        Self::new()
+    }
+}
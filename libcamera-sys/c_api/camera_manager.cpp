@@ -20,10 +20,54 @@ void libcamera_camera_manager_stop(libcamera_camera_manager_t *mgr) {
     mgr->stop();
 }
 
+libcamera_callback_handle_t *libcamera_camera_manager_camera_added_connect(libcamera_camera_manager_t *mgr, libcamera_camera_hotplug_cb_t *callback, void *data) {
+    libcamera_callback_handle_t *handle = new libcamera_callback_handle_t {};
+
+    mgr->cameraAdded.connect(handle, [=](std::shared_ptr<libcamera::Camera> cam) {
+        callback(data, new libcamera_camera_t(std::move(cam)));
+    });
+
+    return handle;
+}
+
+void libcamera_camera_manager_camera_added_disconnect(libcamera_camera_manager_t *mgr, libcamera_callback_handle_t *handle) {
+    mgr->cameraAdded.disconnect(handle);
+    delete handle;
+}
+
+libcamera_callback_handle_t *libcamera_camera_manager_camera_removed_connect(libcamera_camera_manager_t *mgr, libcamera_camera_hotplug_cb_t *callback, void *data) {
+    libcamera_callback_handle_t *handle = new libcamera_callback_handle_t {};
+
+    mgr->cameraRemoved.connect(handle, [=](std::shared_ptr<libcamera::Camera> cam) {
+        callback(data, new libcamera_camera_t(std::move(cam)));
+    });
+
+    return handle;
+}
+
+void libcamera_camera_manager_camera_removed_disconnect(libcamera_camera_manager_t *mgr, libcamera_callback_handle_t *handle) {
+    mgr->cameraRemoved.disconnect(handle);
+    delete handle;
+}
+
 libcamera_camera_list_t *libcamera_camera_manager_cameras(const libcamera_camera_manager_t *mgr) {
     return new libcamera_camera_list_t(std::move(mgr->cameras()));
 }
 
+size_t libcamera_camera_manager_enumerate(const libcamera_camera_manager_t *mgr, const char **ids, size_t capacity) {
+    auto cameras = mgr->cameras();
+    size_t count = cameras.size() < capacity ? cameras.size() : capacity;
+
+    // The id strings are owned by the Camera objects, which the manager keeps alive, so they
+    // remain valid after the temporary shared_ptr vector is destroyed.
+    for (size_t i = 0; i < count; i++)
+        ids[i] = cameras[i]->id().c_str();
+
+    // Returns the total camera count. If it exceeds capacity, the caller has to grow its buffer
+    // and retry.
+    return cameras.size();
+}
+
 libcamera_camera_t *libcamera_camera_manager_get_id(libcamera_camera_manager_t *mgr, const char *id) {
     auto camera = mgr->get(std::string(id));
 
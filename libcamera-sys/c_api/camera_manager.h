@@ -6,6 +6,8 @@
 #include <stddef.h>
 #include <sys/types.h>
 
+typedef void libcamera_camera_hotplug_cb_t(void*, libcamera_camera_t*);
+
 #ifdef __cplusplus
 #include <libcamera/camera_manager.h>
 
@@ -22,7 +24,12 @@ libcamera_camera_manager_t *libcamera_camera_manager_create();
 void libcamera_camera_manager_destroy(libcamera_camera_manager_t *mgr);
 int libcamera_camera_manager_start(libcamera_camera_manager_t *mgr);
 void libcamera_camera_manager_stop(libcamera_camera_manager_t *mgr);
+libcamera_callback_handle_t *libcamera_camera_manager_camera_added_connect(libcamera_camera_manager_t *mgr, libcamera_camera_hotplug_cb_t *callback, void *data);
+void libcamera_camera_manager_camera_added_disconnect(libcamera_camera_manager_t *mgr, libcamera_callback_handle_t *handle);
+libcamera_callback_handle_t *libcamera_camera_manager_camera_removed_connect(libcamera_camera_manager_t *mgr, libcamera_camera_hotplug_cb_t *callback, void *data);
+void libcamera_camera_manager_camera_removed_disconnect(libcamera_camera_manager_t *mgr, libcamera_callback_handle_t *handle);
 libcamera_camera_list_t *libcamera_camera_manager_cameras(const libcamera_camera_manager_t *mgr);
+size_t libcamera_camera_manager_enumerate(const libcamera_camera_manager_t *mgr, const char **ids, size_t capacity);
 libcamera_camera_t *libcamera_camera_manager_get_id(libcamera_camera_manager_t *mgr, const char *id);
 libcamera_camera_t *libcamera_camera_manager_get_dev(libcamera_camera_manager_t *mgr, dev_t dev);
 const char *libcamera_camera_manager_version(libcamera_camera_manager_t *mgr);
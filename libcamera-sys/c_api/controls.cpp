@@ -5,38 +5,48 @@
 
 extern "C" {
 
+// Name and type lookups use the dense generated tables instead of the std::map
+// of libcamera::controls::controls, so they are O(1) with no pointer chasing.
 const char *libcamera_control_name(enum libcamera_control_id id) {
-    auto it = libcamera::controls::controls.find(id);
-    if (it != libcamera::controls::controls.end())
-        return it->second->name().c_str();
+    unsigned int index = (unsigned int)id - 1;
+    if (index < LIBCAMERA_CONTROL_ID_COUNT)
+        return libcamera_control_id_names[index];
     else
         return nullptr;
 }
 
 enum libcamera_control_type libcamera_control_type(enum libcamera_control_id id) {
-    auto it = libcamera::controls::controls.find(id);
-    if (it != libcamera::controls::controls.end())
-        return (enum libcamera_control_type)it->second->type();
+    unsigned int index = (unsigned int)id - 1;
+    if (index < LIBCAMERA_CONTROL_ID_COUNT)
+        return (enum libcamera_control_type)libcamera_control_id_types[index];
     else
         return LIBCAMERA_CONTROL_TYPE_NONE;
 }
 
 const char *libcamera_property_name(enum libcamera_property_id id) {
-    auto it = libcamera::properties::properties.find(id);
-    if (it != libcamera::properties::properties.end())
-        return it->second->name().c_str();
+    unsigned int index = (unsigned int)id - 1;
+    if (index < LIBCAMERA_PROPERTY_ID_COUNT)
+        return libcamera_property_id_names[index];
     else
         return nullptr;
 }
 
 enum libcamera_control_type libcamera_property_type(enum libcamera_property_id id) {
-    auto it = libcamera::properties::properties.find(id);
-    if (it != libcamera::properties::properties.end())
-        return (enum libcamera_control_type)it->second->type();
+    unsigned int index = (unsigned int)id - 1;
+    if (index < LIBCAMERA_PROPERTY_ID_COUNT)
+        return (enum libcamera_control_type)libcamera_property_id_types[index];
     else
         return LIBCAMERA_CONTROL_TYPE_NONE;
 }
 
+libcamera_control_list_t *libcamera_control_list_create() {
+    return new libcamera::ControlList(libcamera::controls::controls);
+}
+
+void libcamera_control_list_destroy(libcamera_control_list_t *list) {
+    delete list;
+}
+
 libcamera_control_value_t *libcamera_control_list_get(libcamera_control_list_t *list, enum libcamera_property_id id) {
     if (list->contains(id)) {
         // if control list contains a value, it will not return `static const ControlValue zero` and is safe to cast
@@ -46,6 +56,59 @@ libcamera_control_value_t *libcamera_control_list_get(libcamera_control_list_t *
     }
 }
 
+int libcamera_control_list_set_batch(libcamera_control_list_t *list, const libcamera_control_list_batch_entry_t *entries, size_t num_entries, const uint8_t *data) {
+    for (size_t i = 0; i < num_entries; i++) {
+        const libcamera_control_list_batch_entry_t &entry = entries[i];
+
+        libcamera::ControlValue val;
+        val.reserve((libcamera::ControlType)entry.type, entry.is_array, entry.num_elements);
+        libcamera::Span<uint8_t> storage = val.data();
+        memcpy(storage.data(), data + entry.offset, storage.size());
+
+        list->set(entry.id, val);
+    }
+
+    return 0;
+}
+
+void libcamera_control_list_merge(libcamera_control_list_t *dst, const libcamera_control_list_t *src) {
+    dst->merge(*src);
+}
+
+long libcamera_control_list_export(const libcamera_control_list_t *list, libcamera_control_list_export_entry_t *entries, size_t max_entries, uint8_t *data, size_t data_capacity, size_t *data_used) {
+    size_t count = 0;
+    size_t used = 0;
+
+    for (const auto &item : *list) {
+        const libcamera::ControlValue &val = item.second;
+        libcamera::Span<const uint8_t> src = val.data();
+
+        // Align value data so that the caller can access elements in place.
+        size_t offset = (used + 7) & ~(size_t)7;
+
+        if (count < max_entries && offset + src.size() <= data_capacity) {
+            libcamera_control_list_export_entry_t &entry = entries[count];
+            entry.id = item.first;
+            entry.type = (uint32_t)val.type();
+            entry.is_array = val.isArray();
+            entry.num_elements = val.numElements();
+            entry.offset = offset;
+            entry.size = src.size();
+            memcpy(data + offset, src.data(), src.size());
+        }
+
+        used = offset + src.size();
+        count++;
+    }
+
+    if (data_used)
+        *data_used = used;
+
+    // Returns the total number of entries in the list. If it exceeds max_entries or
+    // *data_used exceeds data_capacity, the caller has to grow its buffers and retry.
+    return (long)count;
+}
+
 libcamera_control_list_iter_t *libcamera_control_list_iter(libcamera_control_list_t *list) {
     auto it = list->begin();
     return new libcamera_control_list_iter_t { list, it };
@@ -73,6 +136,57 @@ const libcamera_control_value_t *libcamera_control_list_iter_value(libcamera_con
     return &iter->it->second;
 }
 
+size_t libcamera_control_info_map_size(const libcamera_control_info_map_t *map) {
+    return map->size();
+}
+
+const libcamera_control_info_t *libcamera_control_info_map_find(const libcamera_control_info_map_t *map, unsigned int id) {
+    auto it = map->find(id);
+    if (it != map->end())
+        return &it->second;
+    else
+        return nullptr;
+}
+
+libcamera_control_info_map_iter_t *libcamera_control_info_map_iter(const libcamera_control_info_map_t *map) {
+    auto it = map->begin();
+    return new libcamera_control_info_map_iter_t { map, it };
+}
+
+void libcamera_control_info_map_iter_destroy(libcamera_control_info_map_iter_t *iter) {
+    delete iter;
+}
+
+bool libcamera_control_info_map_iter_end(const libcamera_control_info_map_iter_t *iter) {
+    return iter->it == iter->map->end();
+}
+
+void libcamera_control_info_map_iter_next(libcamera_control_info_map_iter_t *iter) {
+    if (iter->it != iter->map->end()) {
+        ++(iter->it);
+    }
+}
+
+unsigned int libcamera_control_info_map_iter_id(libcamera_control_info_map_iter_t *iter) {
+    return iter->it->first->id();
+}
+
+const libcamera_control_info_t *libcamera_control_info_map_iter_info(libcamera_control_info_map_iter_t *iter) {
+    return &iter->it->second;
+}
+
+const libcamera_control_value_t *libcamera_control_info_min(const libcamera_control_info_t *info) {
+    return &info->min();
+}
+
+const libcamera_control_value_t *libcamera_control_info_max(const libcamera_control_info_t *info) {
+    return &info->max();
+}
+
+const libcamera_control_value_t *libcamera_control_info_def(const libcamera_control_info_t *info) {
+    return &info->def();
+}
+
 enum libcamera_control_type libcamera_control_value_type(const libcamera_control_value_t *val) {
     return (enum libcamera_control_type)val->type();
 }
@@ -15,10 +15,17 @@ struct libcamera_control_list_iter {
 	libcamera::ControlList::iterator it;
 };
 
+struct libcamera_control_info_map_iter {
+	const libcamera::ControlInfoMap *map;
+	libcamera::ControlInfoMap::const_iterator it;
+};
+
 typedef libcamera::ControlValue libcamera_control_value_t;
 typedef libcamera::ControlList libcamera_control_list_t;
 typedef struct libcamera_control_list_iter libcamera_control_list_iter_t;
 typedef libcamera::ControlInfoMap libcamera_control_info_map_t;
+typedef struct libcamera_control_info_map_iter libcamera_control_info_map_iter_t;
+typedef libcamera::ControlInfo libcamera_control_info_t;
 
 extern "C" {
 #else
@@ -26,8 +33,38 @@ typedef struct libcamera_control_value libcamera_control_value_t;
 typedef struct libcamera_control_list libcamera_control_list_t;
 typedef struct libcamera_control_list_iter libcamera_control_list_iter_t;
 typedef struct libcamera_control_info_map libcamera_control_info_map_t;
+typedef struct libcamera_control_info_map_iter libcamera_control_info_map_iter_t;
+typedef struct libcamera_control_info libcamera_control_info_t;
 #endif
 
+/// Describes one control inside a batched control list write, see libcamera_control_list_set_batch().
+struct libcamera_control_list_batch_entry {
+    uint32_t id;
+    /// enum libcamera_control_type of the value
+    uint32_t type;
+    uint32_t is_array;
+    uint32_t num_elements;
+    /// Byte offset of the value data within the shared data blob
+    uint32_t offset;
+};
+
+typedef struct libcamera_control_list_batch_entry libcamera_control_list_batch_entry_t;
+
+/// Describes one exported control list entry, see libcamera_control_list_export().
+struct libcamera_control_list_export_entry {
+    uint32_t id;
+    /// enum libcamera_control_type of the value
+    uint32_t type;
+    uint32_t is_array;
+    uint32_t num_elements;
+    /// Byte offset of the value data within the caller-provided data buffer, 8-byte aligned
+    uint32_t offset;
+    /// Byte size of the value data
+    uint32_t size;
+};
+
+typedef struct libcamera_control_list_export_entry libcamera_control_list_export_entry_t;
+
 enum libcamera_control_type {
 	LIBCAMERA_CONTROL_TYPE_NONE,
 	LIBCAMERA_CONTROL_TYPE_BOOL,
@@ -49,7 +86,12 @@ const char *libcamera_property_name(enum libcamera_property_id id);
 enum libcamera_control_type libcamera_property_type(enum libcamera_property_id id);
 
 // --- libcamera_control_list_t ---
+libcamera_control_list_t *libcamera_control_list_create();
+void libcamera_control_list_destroy(libcamera_control_list_t *list);
 libcamera_control_value_t *libcamera_control_list_get(libcamera_control_list_t *list, enum libcamera_property_id id);
+int libcamera_control_list_set_batch(libcamera_control_list_t *list, const libcamera_control_list_batch_entry_t *entries, size_t num_entries, const uint8_t *data);
+void libcamera_control_list_merge(libcamera_control_list_t *dst, const libcamera_control_list_t *src);
+long libcamera_control_list_export(const libcamera_control_list_t *list, libcamera_control_list_export_entry_t *entries, size_t max_entries, uint8_t *data, size_t data_capacity, size_t *data_used);
 libcamera_control_list_iter_t *libcamera_control_list_iter(libcamera_control_list_t *list);
 
 // --- libcamera_control_list_iter_t ---
@@ -59,6 +101,23 @@ void libcamera_control_list_iter_next(libcamera_control_list_iter_t *iter);
 unsigned int libcamera_control_list_iter_id(libcamera_control_list_iter_t *iter);
 const libcamera_control_value_t *libcamera_control_list_iter_value(libcamera_control_list_iter_t *iter);
 
+// --- libcamera_control_info_map_t ---
+size_t libcamera_control_info_map_size(const libcamera_control_info_map_t *map);
+const libcamera_control_info_t *libcamera_control_info_map_find(const libcamera_control_info_map_t *map, unsigned int id);
+libcamera_control_info_map_iter_t *libcamera_control_info_map_iter(const libcamera_control_info_map_t *map);
+
+// --- libcamera_control_info_map_iter_t ---
+void libcamera_control_info_map_iter_destroy(libcamera_control_info_map_iter_t *iter);
+bool libcamera_control_info_map_iter_end(const libcamera_control_info_map_iter_t *iter);
+void libcamera_control_info_map_iter_next(libcamera_control_info_map_iter_t *iter);
+unsigned int libcamera_control_info_map_iter_id(libcamera_control_info_map_iter_t *iter);
+const libcamera_control_info_t *libcamera_control_info_map_iter_info(libcamera_control_info_map_iter_t *iter);
+
+// --- libcamera_control_info_t ---
+const libcamera_control_value_t *libcamera_control_info_min(const libcamera_control_info_t *info);
+const libcamera_control_value_t *libcamera_control_info_max(const libcamera_control_info_t *info);
+const libcamera_control_value_t *libcamera_control_info_def(const libcamera_control_info_t *info);
+
 // --- libcamera_control_value_t ---
 enum libcamera_control_type libcamera_control_value_type(const libcamera_control_value_t *val);
 bool libcamera_control_value_is_none(const libcamera_control_value_t *val);
@@ -3,6 +3,8 @@
 #ifndef __LIBCAMERA_C_CONTROLS_GENERATED__
 #define __LIBCAMERA_C_CONTROLS_GENERATED__
 
+#include <stdint.h>
+
 
 enum libcamera_control_id {
     /**
@@ -984,6 +986,115 @@ enum libcamera_test_pattern_mode {
     LIBCAMERA_TEST_PATTERN_MODE_CUSTOM_1 = 256,
 };
 
+#define LIBCAMERA_CONTROL_ID_COUNT 48
+
+#ifdef __cplusplus
+/**
+ * \brief Dense id-indexed lookup tables for control metadata (index = id - 1)
+ */
+static constexpr const char *const libcamera_control_id_names[LIBCAMERA_CONTROL_ID_COUNT] = {
+    "AeEnable",
+    "AeLocked",
+    "AeMeteringMode",
+    "AeConstraintMode",
+    "AeExposureMode",
+    "ExposureValue",
+    "ExposureTime",
+    "AnalogueGain",
+    "Brightness",
+    "Contrast",
+    "Lux",
+    "AwbEnable",
+    "AwbMode",
+    "AwbLocked",
+    "ColourGains",
+    "ColourTemperature",
+    "Saturation",
+    "SensorBlackLevels",
+    "Sharpness",
+    "FocusFoM",
+    "ColourCorrectionMatrix",
+    "ScalerCrop",
+    "DigitalGain",
+    "FrameDuration",
+    "FrameDurationLimits",
+    "SensorTemperature",
+    "SensorTimestamp",
+    "AfMode",
+    "AfRange",
+    "AfSpeed",
+    "AfMetering",
+    "AfWindows",
+    "AfTrigger",
+    "AfPause",
+    "LensPosition",
+    "AfState",
+    "AfPauseState",
+    "AePrecaptureTrigger",
+    "NoiseReductionMode",
+    "ColorCorrectionAberrationMode",
+    "AeState",
+    "AwbState",
+    "SensorRollingShutterSkew",
+    "LensShadingMapMode",
+    "SceneFlicker",
+    "PipelineDepth",
+    "MaxLatency",
+    "TestPatternMode",
+};
+
+static constexpr uint8_t libcamera_control_id_types[LIBCAMERA_CONTROL_ID_COUNT] = {
+    1, /* AeEnable: bool */
+    1, /* AeLocked: bool */
+    3, /* AeMeteringMode: int32_t */
+    3, /* AeConstraintMode: int32_t */
+    3, /* AeExposureMode: int32_t */
+    5, /* ExposureValue: float */
+    3, /* ExposureTime: int32_t */
+    5, /* AnalogueGain: float */
+    5, /* Brightness: float */
+    5, /* Contrast: float */
+    5, /* Lux: float */
+    1, /* AwbEnable: bool */
+    3, /* AwbMode: int32_t */
+    1, /* AwbLocked: bool */
+    5, /* ColourGains: float */
+    3, /* ColourTemperature: int32_t */
+    5, /* Saturation: float */
+    3, /* SensorBlackLevels: int32_t */
+    5, /* Sharpness: float */
+    3, /* FocusFoM: int32_t */
+    5, /* ColourCorrectionMatrix: float */
+    7, /* ScalerCrop: Rectangle */
+    5, /* DigitalGain: float */
+    4, /* FrameDuration: int64_t */
+    4, /* FrameDurationLimits: int64_t */
+    5, /* SensorTemperature: float */
+    4, /* SensorTimestamp: int64_t */
+    3, /* AfMode: int32_t */
+    3, /* AfRange: int32_t */
+    3, /* AfSpeed: int32_t */
+    3, /* AfMetering: int32_t */
+    7, /* AfWindows: Rectangle */
+    3, /* AfTrigger: int32_t */
+    3, /* AfPause: int32_t */
+    5, /* LensPosition: float */
+    3, /* AfState: int32_t */
+    3, /* AfPauseState: int32_t */
+    3, /* AePrecaptureTrigger: int32_t */
+    3, /* NoiseReductionMode: int32_t */
+    3, /* ColorCorrectionAberrationMode: int32_t */
+    3, /* AeState: int32_t */
+    3, /* AwbState: int32_t */
+    4, /* SensorRollingShutterSkew: int64_t */
+    3, /* LensShadingMapMode: int32_t */
+    3, /* SceneFlicker: int32_t */
+    3, /* PipelineDepth: int32_t */
+    3, /* MaxLatency: int32_t */
+    3, /* TestPatternMode: int32_t */
+};
+#endif
+
 enum libcamera_property_id {
     /**
      * Camera mounting location
@@ -1703,4 +1814,37 @@ enum libcamera_color_filter_arrangement {
     LIBCAMERA_MONO = 5,
 };
 
+#define LIBCAMERA_PROPERTY_ID_COUNT 10
+
+#ifdef __cplusplus
+/**
+ * \brief Dense id-indexed lookup tables for property metadata (index = id - 1)
+ */
+static constexpr const char *const libcamera_property_id_names[LIBCAMERA_PROPERTY_ID_COUNT] = {
+    "Location",
+    "Rotation",
+    "Model",
+    "UnitCellSize",
+    "PixelArraySize",
+    "PixelArrayOpticalBlackRectangles",
+    "PixelArrayActiveAreas",
+    "ScalerCropMaximum",
+    "SensorSensitivity",
+    "ColorFilterArrangement",
+};
+
+static constexpr uint8_t libcamera_property_id_types[LIBCAMERA_PROPERTY_ID_COUNT] = {
+    3, /* Location: int32_t */
+    3, /* Rotation: int32_t */
+    6, /* Model: string */
+    8, /* UnitCellSize: Size */
+    8, /* PixelArraySize: Size */
+    7, /* PixelArrayOpticalBlackRectangles: Rectangle */
+    7, /* PixelArrayActiveAreas: Rectangle */
+    7, /* ScalerCropMaximum: Rectangle */
+    5, /* SensorSensitivity: float */
+    3, /* ColorFilterArrangement: int32_t */
+};
+#endif
+
 #endif
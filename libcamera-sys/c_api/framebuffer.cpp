@@ -19,6 +19,21 @@ libcamera_frame_metadata_planes_t *libcamera_frame_metadata_planes(libcamera_fra
     return new libcamera::Span<libcamera::FrameMetadata::Plane>(std::move(metadata->planes()));
 }
 
+void libcamera_frame_metadata_read(const libcamera_frame_metadata_t *metadata, libcamera_frame_metadata_snapshot_t *snapshot) {
+    snapshot->status = metadata->status;
+    snapshot->sequence = metadata->sequence;
+    snapshot->timestamp = metadata->timestamp;
+
+    const auto planes = metadata->planes();
+    size_t num_planes = planes.size();
+    if (num_planes > LIBCAMERA_FRAME_METADATA_MAX_PLANES)
+        num_planes = LIBCAMERA_FRAME_METADATA_MAX_PLANES;
+
+    snapshot->num_planes = num_planes;
+    for (size_t i = 0; i < num_planes; i++)
+        snapshot->planes[i].bytes_used = planes[i].bytesused;
+}
+
 // --- libcamera_frame_metadata_planes_t ---
 void libcamera_frame_metadata_planes_destroy(libcamera_frame_metadata_planes_t *planes) {
     delete planes;
@@ -13,6 +13,17 @@ struct libcamera_frame_metadata_plane {
     unsigned int bytes_used;
 };
 
+#define LIBCAMERA_FRAME_METADATA_MAX_PLANES 8
+
+/// Plain-data copy of libcamera::FrameMetadata that can be filled in a single call with no allocation.
+struct libcamera_frame_metadata_snapshot {
+    uint32_t status;
+    uint32_t sequence;
+    uint64_t timestamp;
+    uint32_t num_planes;
+    struct libcamera_frame_metadata_plane planes[LIBCAMERA_FRAME_METADATA_MAX_PLANES];
+};
+
 #ifdef __cplusplus
 #include <libcamera/camera.h>
 
@@ -20,6 +31,7 @@ typedef libcamera::FrameMetadata::Status libcamera_frame_metadata_status_t;
 typedef libcamera::FrameMetadata::Plane libcamera_frame_metadata_plane_t;
 typedef libcamera::Span<libcamera::FrameMetadata::Plane> libcamera_frame_metadata_planes_t;
 typedef libcamera::FrameMetadata libcamera_frame_metadata_t;
+typedef struct libcamera_frame_metadata_snapshot libcamera_frame_metadata_snapshot_t;
 typedef libcamera::FrameBuffer::Plane libcamera_framebuffer_plane_t;
 typedef std::vector<libcamera::FrameBuffer::Plane> libcamera_framebuffer_planes_t;
 typedef libcamera::FrameBuffer libcamera_framebuffer_t;
@@ -33,6 +45,7 @@ typedef enum libcamera_frame_metadata_status libcamera_frame_metadata_status_t;
 typedef struct libcamera_frame_metadata_plane libcamera_frame_metadata_plane_t;
 typedef struct libcamera_frame_metadata_planes libcamera_frame_metadata_planes_t;
 typedef struct libcamera_frame_metadata libcamera_frame_metadata_t;
+typedef struct libcamera_frame_metadata_snapshot libcamera_frame_metadata_snapshot_t;
 typedef struct libcamera_framebuffer_plane libcamera_framebuffer_plane_t;
 typedef struct libcamera_framebuffer_planes libcamera_framebuffer_planes_t;
 typedef struct libcamera_framebuffer libcamera_framebuffer_t;
@@ -43,6 +56,7 @@ libcamera_frame_metadata_status_t libcamera_frame_metadata_status(const libcamer
 unsigned int libcamera_frame_metadata_sequence(const libcamera_frame_metadata_t *metadata);
 uint64_t libcamera_frame_metadata_timestamp(const libcamera_frame_metadata_t *metadata);
 libcamera_frame_metadata_planes_t *libcamera_frame_metadata_planes(libcamera_frame_metadata_t *metadata);
+void libcamera_frame_metadata_read(const libcamera_frame_metadata_t *metadata, libcamera_frame_metadata_snapshot_t *snapshot);
 
 // --- libcamera_frame_metadata_planes_t ---
 void libcamera_frame_metadata_planes_destroy(libcamera_frame_metadata_planes_t *planes);
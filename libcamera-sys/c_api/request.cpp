@@ -6,6 +6,10 @@ void libcamera_request_destroy(libcamera_request_t *request) {
     delete request;
 }
 
+void libcamera_request_reuse(libcamera_request_t *request, libcamera_request_reuse_flag_t flags) {
+    request->reuse(flags);
+}
+
 libcamera_control_list_t *libcamera_request_controls(libcamera_request_t *request) {
     return &request->controls();
 }
@@ -13,6 +13,11 @@ enum libcamera_request_status {
     LIBCAMERA_REQUEST_STATUS_CANCELLED,
 };
 
+enum libcamera_request_reuse_flag {
+    LIBCAMERA_REQUEST_REUSE_DEFAULT = 0,
+    LIBCAMERA_REQUEST_REUSE_BUFFERS = 1 << 0,
+};
+
 #ifdef __cplusplus
 #include <libcamera/camera.h>
 
@@ -22,6 +27,7 @@ struct libcamera_request_buffer_map_iter {
 };
 
 typedef libcamera::Request::Status libcamera_request_status_t;
+typedef libcamera::Request::ReuseFlag libcamera_request_reuse_flag_t;
 typedef libcamera::Request libcamera_request_t;
 typedef libcamera::Request::BufferMap libcamera_request_buffer_map_t;
 typedef struct libcamera_request_buffer_map_iter libcamera_request_buffer_map_iter_t;
@@ -29,6 +35,7 @@ typedef struct libcamera_request_buffer_map_iter libcamera_request_buffer_map_it
 extern "C" {
 #else
 typedef enum libcamera_request_status libcamera_request_status_t;
+typedef enum libcamera_request_reuse_flag libcamera_request_reuse_flag_t;
 typedef struct libcamera_request libcamera_request_t;
 typedef struct libcamera_request_buffer_map libcamera_request_buffer_map_t;
 typedef struct libcamera_request_buffer_map_iter libcamera_request_buffer_map_iter_t;
@@ -36,6 +43,7 @@ typedef struct libcamera_request_buffer_map_iter libcamera_request_buffer_map_it
 
 // --- libcamera_request_t ---
 void libcamera_request_destroy(libcamera_request_t *request);
+void libcamera_request_reuse(libcamera_request_t *request, libcamera_request_reuse_flag_t flags);
 libcamera_control_list_t *libcamera_request_controls(libcamera_request_t *request);
 libcamera_control_list_t *libcamera_request_metadata(libcamera_request_t *request);
 const libcamera_request_buffer_map_t *libcamera_request_buffers(const libcamera_request_t *request);
@@ -16,6 +16,34 @@ libcamera_size_range_t libcamera_stream_formats_range(const libcamera_stream_for
     return formats->range(*pixel_format);
 }
 
+long libcamera_stream_formats_dump(const libcamera_stream_formats_t *formats, libcamera_stream_formats_dump_entry_t *entries, size_t max_entries, libcamera_size_t *sizes, size_t max_sizes, size_t *sizes_used) {
+    size_t count = 0;
+    size_t used = 0;
+
+    for (const libcamera::PixelFormat &pixel_format : formats->pixelformats()) {
+        std::vector<libcamera::Size> format_sizes = formats->sizes(pixel_format);
+
+        if (count < max_entries && used + format_sizes.size() <= max_sizes) {
+            libcamera_stream_formats_dump_entry_t &entry = entries[count];
+            entry.pixel_format = pixel_format;
+            entry.range = formats->range(pixel_format);
+            entry.sizes_offset = used;
+            entry.num_sizes = format_sizes.size();
+            std::copy(format_sizes.begin(), format_sizes.end(), sizes + used);
+        }
+
+        used += format_sizes.size();
+        count++;
+    }
+
+    if (sizes_used)
+        *sizes_used = used;
+
+    // Returns the total number of pixel formats. If it exceeds max_entries or *sizes_used
+    // exceeds max_sizes, the caller has to grow its buffers and retry.
+    return (long)count;
+}
+
 const libcamera_stream_formats_t *libcamera_stream_configuration_formats(const libcamera_stream_configuration_t *config) {
     return &config->formats();
 }
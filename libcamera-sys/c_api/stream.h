@@ -15,6 +15,17 @@ struct libcamera_stream_configuration {
     uint8_t __padding[72];
 };
 
+struct libcamera_stream_formats_dump_entry {
+    libcamera_pixel_format_t pixel_format;
+    libcamera_size_range_t range;
+    /// Index of the first supported size within the caller-provided sizes buffer
+    uint32_t sizes_offset;
+    /// Number of supported sizes
+    uint32_t num_sizes;
+};
+
+typedef struct libcamera_stream_formats_dump_entry libcamera_stream_formats_dump_entry_t;
+
 #ifdef __cplusplus
 #include <libcamera/camera.h>
 
@@ -56,6 +67,7 @@ enum libcamera_stream_role {
 libcamera_pixel_formats_t *libcamera_stream_formats_pixel_formats(const libcamera_stream_formats_t* formats);
 libcamera_sizes_t *libcamera_stream_formats_sizes(const libcamera_stream_formats_t* formats, const libcamera_pixel_format_t *pixel_format);
 libcamera_size_range_t libcamera_stream_formats_range(const libcamera_stream_formats_t* formats, const libcamera_pixel_format_t *pixel_format);
+long libcamera_stream_formats_dump(const libcamera_stream_formats_t *formats, libcamera_stream_formats_dump_entry_t *entries, size_t max_entries, libcamera_size_t *sizes, size_t max_sizes, size_t *sizes_used);
 
 const libcamera_stream_formats_t *libcamera_stream_configuration_formats(const libcamera_stream_configuration_t *config);
 libcamera_stream_t *libcamera_stream_configuration_stream(const libcamera_stream_configuration_t *config);